@@ -27,6 +27,11 @@
 
 namespace blockchain
 {
+    #define ABI_WORD_LENGTH 32
+    /// Validation may visit at most this many values per word of input. Offsets are allowed to alias, so without a bound
+    /// nested dynamic arrays sharing one offset would take time exponential in the nesting depth.
+    #define ABI_VALIDATION_VALUES_PER_WORD 4
+
     Address ABIDecoder::DecodeAddress(const char *result)
     {
         char addr[strlen(result)];
@@ -34,4 +39,256 @@ namespace blockchain
 
         return Address(addr | byte_array::hex_string_to_bytes);
     }
-}
\ No newline at end of file
+
+    BigNumber ABIDecoder::DecodeInt(const char *result)
+    {
+        std::vector<uint8_t> bytes = result | byte_array::hex_string_to_bytes;
+        if (bytes.size() < 32)
+        {
+            THROW("Unable to decode int. Result is shorter than 32 bytes.");
+        }
+        return BigNumber::FromTwosComplement(bytes.data(), 32);
+    }
+
+    /// @brief Reads a word used as an offset or a length. Returns false if the value does not fit in 32 bits.
+    static bool readSize(const uint8_t *word, size_t &value)
+    {
+        for (size_t i = 0; i < ABI_WORD_LENGTH - 4; i++)
+        {
+            if (word[i] != 0) { return false; }
+        }
+        value = ((size_t)word[28] << 24) | ((size_t)word[29] << 16) | ((size_t)word[30] << 8) | word[31];
+        return true;
+    }
+
+    /// @brief Reads an offset or a length of data that has been validated by `ABIDecoder::Decode`.
+    static size_t readValidatedSize(const uint8_t *word)
+    {
+        size_t value = 0;
+        if (!readSize(word, value))
+        {
+            THROW("ABIValue references data that has not been validated.");
+        }
+        return value;
+    }
+
+    static bool isPaddedWith(const uint8_t *begin, const uint8_t *end, uint8_t padding)
+    {
+        for (const uint8_t *b = begin; b < end; b++)
+        {
+            if (*b != padding) { return false; }
+        }
+        return true;
+    }
+
+    /// @brief Verifies that the unused bits of a static word are properly padded.
+    static bool validateWord(const ABIType &type, const uint8_t *word)
+    {
+        size_t used = type.Size() / 8;
+        switch (type.Kind())
+        {
+        case ABITypeKind::UnsignedInt:
+        case ABITypeKind::Address:
+            return isPaddedWith(word, word + ABI_WORD_LENGTH - used, 0);
+        case ABITypeKind::SignedInt:
+            return isPaddedWith(word, word + ABI_WORD_LENGTH - used, (word[ABI_WORD_LENGTH - used] & 0x80) ? 0xFF : 0);
+        case ABITypeKind::Bool:
+            return isPaddedWith(word, word + ABI_WORD_LENGTH - 1, 0) && word[ABI_WORD_LENGTH - 1] <= 1;
+        case ABITypeKind::FixedBytes:
+            return isPaddedWith(word + type.Size(), word + ABI_WORD_LENGTH, 0);
+        default:
+            return false;
+        }
+    }
+
+    static bool validate(const ABIType &type, const uint8_t *location, const uint8_t *end, size_t &budget);
+
+    /// @brief Validates the element at `headPosition` of the tuple-like region starting at `region`.
+    static bool validateElement(const ABIType &type, const uint8_t *region, size_t headPosition, const uint8_t *end, size_t &budget)
+    {
+        size_t available = end - region;
+        if (headPosition > available || available - headPosition < type.HeadSize()) { return false; }
+        if (!type.IsDynamic()) { return validate(type, region + headPosition, end, budget); }
+
+        size_t offset;
+        if (!readSize(region + headPosition, offset) || offset > available) { return false; }
+        return validate(type, region + offset, end, budget);
+    }
+
+    /// @brief Validates the value of `type` at `location`. Every value other than a tuple or a fixed-size array occupies
+    /// at least one word and is charged against `budget`; validation fails once it is exhausted.
+    static bool validate(const ABIType &type, const uint8_t *location, const uint8_t *end, size_t &budget)
+    {
+        size_t available = end - location;
+        if (type.Kind() != ABITypeKind::Tuple && type.Kind() != ABITypeKind::FixedArray)
+        {
+            if (budget == 0) { return false; }
+            budget--;
+        }
+        switch (type.Kind())
+        {
+        case ABITypeKind::Bytes:
+        case ABITypeKind::String:
+        {
+            size_t length;
+            if (available < ABI_WORD_LENGTH || !readSize(location, length)) { return false; }
+            return length <= available - ABI_WORD_LENGTH;
+        }
+        case ABITypeKind::Array:
+        {
+            const ABIType &element = type.Components()[0];
+            size_t count;
+            if (available < ABI_WORD_LENGTH || !readSize(location, count)) { return false; }
+            if (count > (available - ABI_WORD_LENGTH) / element.HeadSize()) { return false; }
+            for (size_t i = 0; i < count; i++)
+            {
+                if (!validateElement(element, location + ABI_WORD_LENGTH, i * element.HeadSize(), end, budget)) { return false; }
+            }
+            return true;
+        }
+        case ABITypeKind::FixedArray:
+        {
+            const ABIType &element = type.Components()[0];
+            for (size_t i = 0; i < type.Size(); i++)
+            {
+                if (!validateElement(element, location, i * element.HeadSize(), end, budget)) { return false; }
+            }
+            return true;
+        }
+        case ABITypeKind::Tuple:
+        {
+            size_t headPosition = 0;
+            for (const ABIType &component : type.Components())
+            {
+                if (!validateElement(component, location, headPosition, end, budget)) { return false; }
+                headPosition += component.HeadSize();
+            }
+            return true;
+        }
+        default:
+            return available >= ABI_WORD_LENGTH && validateWord(type, location);
+        }
+    }
+
+    Result<ABIValue> ABIDecoder::Decode(const ABIType *type, const uint8_t *data, size_t length) const
+    {
+        size_t budget = (length / ABI_WORD_LENGTH) * ABI_VALIDATION_VALUES_PER_WORD;
+        if (!validate(*type, data, data + length, budget))
+        {
+            return Result<ABIValue>::Err(ABI_DECODE_ERROR, "Data is not a valid ABI encoding of the type.");
+        }
+        return ABIValue(type, data, data + length);
+    }
+
+    void ABIValue::AssertKind(bool valid) const
+    {
+        if (type == nullptr || !valid)
+        {
+            THROW("ABIValue has an incompatible type.");
+        }
+    }
+
+    const ABIType &ABIValue::Type() const
+    {
+        AssertKind(true);
+        return *type;
+    }
+
+    size_t ABIValue::Count() const
+    {
+        AssertKind(true);
+        switch (type->Kind())
+        {
+        case ABITypeKind::Array:
+            return readValidatedSize(data);
+        case ABITypeKind::FixedArray:
+            return type->Size();
+        case ABITypeKind::Tuple:
+            return type->Components().size();
+        default:
+            THROW("ABIValue is not an array or a tuple.");
+            return 0;
+        }
+    }
+
+    ABIValue ABIValue::operator[](size_t index) const
+    {
+        if (index >= Count())
+        {
+            THROW("ABIValue index out of range.");
+        }
+
+        const uint8_t *region = data;
+        const ABIType *element;
+        size_t headPosition = 0;
+
+        if (type->Kind() == ABITypeKind::Tuple)
+        {
+            element = &type->Components()[index];
+            for (size_t i = 0; i < index; i++) { headPosition += type->Components()[i].HeadSize(); }
+        }
+        else
+        {
+            element = &type->Components()[0];
+            headPosition = index * element->HeadSize();
+            if (type->Kind() == ABITypeKind::Array) { region += ABI_WORD_LENGTH; }
+        }
+
+        if (!element->IsDynamic())
+        {
+            return ABIValue(element, region + headPosition, end);
+        }
+
+        return ABIValue(element, region + readValidatedSize(region + headPosition), end);
+    }
+
+    BigNumber ABIValue::ToBigNumber() const
+    {
+        AssertKind(type != nullptr && (type->Kind() == ABITypeKind::UnsignedInt || type->Kind() == ABITypeKind::SignedInt));
+        if (type->Kind() == ABITypeKind::SignedInt)
+        {
+            return BigNumber::FromTwosComplement(data, ABI_WORD_LENGTH);
+        }
+        return BigNumber::FromBigEndian(data, ABI_WORD_LENGTH);
+    }
+
+    bool ABIValue::ToBool() const
+    {
+        AssertKind(type != nullptr && type->Kind() == ABITypeKind::Bool);
+        return data[ABI_WORD_LENGTH - 1] != 0;
+    }
+
+    Address ABIValue::ToAddress() const
+    {
+        AssertKind(type != nullptr && type->Kind() == ABITypeKind::Address);
+        const char *digits = "0123456789abcdef";
+        char address[ETH_ADDRESS_LENGTH + 1] = { '0', 'x' };
+        for (size_t i = 0; i < (ETH_ADDRESS_LENGTH - 2) / 2; i++)
+        {
+            uint8_t b = data[ABI_WORD_LENGTH - (ETH_ADDRESS_LENGTH - 2) / 2 + i];
+            address[2 + i * 2] = digits[b >> 4];
+            address[3 + i * 2] = digits[b & 0x0F];
+        }
+        return Address(address);
+    }
+
+    ByteView ABIValue::Bytes() const
+    {
+        AssertKind(type != nullptr && (type->Kind() == ABITypeKind::FixedBytes || type->Kind() == ABITypeKind::Bytes || type->Kind() == ABITypeKind::String));
+        if (type->Kind() == ABITypeKind::FixedBytes)
+        {
+            return ByteView(data, type->Size());
+        }
+        return ByteView(data + ABI_WORD_LENGTH, readValidatedSize(data));
+    }
+
+    char *ABIValue::GenerateString() const
+    {
+        AssertKind(type != nullptr && (type->Kind() == ABITypeKind::Bytes || type->Kind() == ABITypeKind::String));
+        ByteView bytes = Bytes();
+        char *string = new char[bytes.size() + 1];
+        memcpy(string, bytes.data(), bytes.size());
+        string[bytes.size()] = '\0';
+        return string;
+    }
+}
@@ -30,9 +30,56 @@
 #include "TransactionResponse.h"
 #include "Encodable.h"
 #include "Address.h"
+#include "ABIType.h"
 
 namespace blockchain
 {
+    #define ABI_DECODE_ERROR -52
+
+    /// @brief A view of a value in ABI-encoded data, obtained from `ABIDecoder::Decode`.
+    /// The value references both the `ABIType` and the encoded data, which must outlive it.
+    class ABIValue
+    {
+    public:
+        /// @brief Creates an empty value.
+        ABIValue() : type(nullptr), data(nullptr), end(nullptr) {}
+
+        /// @brief Returns the type of the value.
+        const ABIType &Type() const;
+
+        /// @brief Returns the number of elements of an array or the number of components of a tuple.
+        size_t Count() const;
+
+        /// @brief Returns an element of an array or a component of a tuple.
+        /// @param index Must be less than `Count()`.
+        /// @return
+        ABIValue operator[](size_t index) const;
+
+        /// @brief Returns the value of a `uintN` or `intN`.
+        BigNumber ToBigNumber() const;
+
+        /// @brief Returns the value of a `bool`.
+        bool ToBool() const;
+
+        /// @brief Returns the value of an `address`.
+        Address ToAddress() const;
+
+        /// @brief Returns a view of the contents of a `bytes`, `string` or `bytesN` without copying.
+        ByteView Bytes() const;
+
+        /// @brief Returns a null-terminated copy of a `string` or `bytes`. Please note that the returned string needs to be deallocated manually.
+        char *GenerateString() const;
+
+    private:
+        friend class ABIDecoder;
+        ABIValue(const ABIType *type, const uint8_t *data, const uint8_t *end) : type(type), data(data), end(end) {}
+
+        void AssertKind(bool valid) const;
+
+        const ABIType *type;
+        const uint8_t *data;
+        const uint8_t *end;
+    };
 
     /// @brief Default interface for decoding ABI information
     class ABIDecoder
@@ -43,6 +90,27 @@ namespace blockchain
         /// @param result 
         /// @return 
         Address DecodeAddress(const char *result);
+
+        /// @brief Decode raw `result` data (the first 32-byte word) into a signed integer (`int8` to `int256`).
+        /// @param result 
+        /// @return 
+        BigNumber DecodeInt(const char *result);
+
+        /// @brief Decodes `data` as the ABI encoding of `type` (usually a tuple obtained from `ABIType::Parse`).
+        /// All offsets, lengths and paddings are validated up front, so the returned value can be traversed without further checks.
+        /// Offsets may alias, but data that would make validation visit more than a few values per word is rejected.
+        /// No data is copied: the returned value references both `type` and `data`.
+        /// @param type 
+        /// @param data 
+        /// @param length The number of bytes in `data`.
+        /// @return The decoded value or `ABI_DECODE_ERROR` if `data` is not a valid encoding of `type`.
+        Result<ABIValue> Decode(const ABIType *type, const uint8_t *data, size_t length) const;
+
+        /// @brief Decodes `data` as the ABI encoding of `type`. See `Decode(const ABIType *, const uint8_t *, size_t)`.
+        /// @param type 
+        /// @param data 
+        /// @return 
+        Result<ABIValue> Decode(const ABIType *type, const std::vector<uint8_t> *data) const { return Decode(type, data->data(), data->size()); }
     };
 }
 
@@ -23,6 +23,7 @@
  */
 
 #include <cassert>
+#include <cstring>
 
 #include "ABIEncoder.h"
 #include "../Shared/Common.h"
@@ -31,75 +32,250 @@ namespace blockchain
 {
     #define ARGUMENT_LENGTH 32
 
-    bool leftPad(EncodableItemType type)
+    // Writes `value` right-aligned into a 32-byte slot.
+    void writeSlot(uint8_t *slot, const uint8_t *value, const size_t length)
     {
-        return  type == EncodableItemType::Bool ||
-                type == EncodableItemType::UnsignedInt ||
-                type == EncodableItemType::Address;
+        if (length > ARGUMENT_LENGTH)
+        {
+            THROW("Unable to ABI-encode value. Static values can't exceed 32 bytes.");
+        }
+        memset(slot, 0, ARGUMENT_LENGTH - length);
+        memcpy(slot + ARGUMENT_LENGTH - length, value, length);
+    }
+
+    void writeSize(uint8_t *slot, size_t value)
+    {
+        memset(slot, 0, ARGUMENT_LENGTH);
+        for (size_t i = 0; i < sizeof(size_t); i++)
+        {
+            slot[ARGUMENT_LENGTH - i - 1] = (uint8_t)(value >> (i * 8));
+        }
     }
 
-    bool rightPad(EncodableItemType type)
+    size_t paddedLength(const size_t length)
     {
-        return type == EncodableItemType::String;
+        return (length + ARGUMENT_LENGTH - 1) / ARGUMENT_LENGTH * ARGUMENT_LENGTH;
     }
 
-    void pad(std::vector<uint8_t> *argument, const std::vector<uint8_t> &value, const bool left = true, const size_t argumentLength = ARGUMENT_LENGTH)
+    bool ABIEncoder::IsDynamic(const EncodableItem *item)
     {
-        assert(value.size() <= argumentLength);
-        size_t start = argumentLength - value.size();
-        for (size_t i = 0; i < value.size(); i++)
+        switch (item->Type())
         {
-            if(left) { argument->at(start + i) = value.at(i); }
-            else { argument->at(i) = value.at(i); }
+        case EncodableItemType::ItemArray:
+        case EncodableItemType::Binary:
+        case EncodableItemType::String:
+            return true;
+        case EncodableItemType::FixedArray:
+        case EncodableItemType::Tuple:
+            // Fixed-size arrays and tuples are dynamic if any of their components are.
+            for (const EncodableItem &child : item->Children())
+            {
+                if (IsDynamic(&child)) { return true; }
+            }
+            return false;
+        default:
+            return false;
         }
     }
 
-    size_t getVectorSize(const EncodableItem *item) 
+    std::vector<uint8_t> ABIEncoder::Encode(const EncodableItem *item) const
+    {
+        std::vector<uint8_t> encoded(EncodedSize(item));
+        Write(item, encoded.data());
+        return encoded;
+    }
+
+    size_t ABIEncoder::EncodedSize(const EncodableItem *item) const
     {
         if (item->Type() == EncodableItemType::ItemArray)
         {
-            return ARGUMENT_LENGTH + item->Children().size() * ARGUMENT_LENGTH;
+            return ARGUMENT_LENGTH + EncodedSize(item->Children());
+        }
+        else if (item->Type() == EncodableItemType::FixedArray || item->Type() == EncodableItemType::Tuple)
+        {
+            return EncodedSize(item->Children());
         }
         else if (item->Type() == EncodableItemType::Binary || item->Type() == EncodableItemType::String)
         {
-            return ARGUMENT_LENGTH + (item->Bytes().size() / ARGUMENT_LENGTH + 1) * ARGUMENT_LENGTH;
+            return ARGUMENT_LENGTH + paddedLength(item->Bytes().size());
+        }
+        return ARGUMENT_LENGTH;
+    }
+
+    size_t ABIEncoder::Write(const EncodableItem *item, uint8_t *buffer) const
+    {
+        if (item->Type() == EncodableItemType::ItemArray)
+        {
+            const std::vector<EncodableItem> &children = item->Children();
+            writeSize(buffer, children.size());
+            return ARGUMENT_LENGTH + Write(children, buffer + ARGUMENT_LENGTH);
+        }
+        else if (item->Type() == EncodableItemType::FixedArray || item->Type() == EncodableItemType::Tuple)
+        {
+            // Encoded in place like a tuple, without a length prefix.
+            return Write(item->Children(), buffer);
         }
         
+        const ByteView bytes = item->Bytes();
+        
+        if (item->Type() == EncodableItemType::Binary || item->Type() == EncodableItemType::String)
+        {
+            const size_t length = paddedLength(bytes.size());
+            writeSize(buffer, bytes.size());
+            memcpy(buffer + ARGUMENT_LENGTH, bytes.data(), bytes.size());
+            memset(buffer + ARGUMENT_LENGTH + bytes.size(), 0, length - bytes.size());
+            return ARGUMENT_LENGTH + length;
+        }
+        else if (item->Type() == EncodableItemType::FixedBytes)
+        {
+            // bytesN is left-aligned.
+            memcpy(buffer, bytes.data(), bytes.size());
+            memset(buffer + bytes.size(), 0, ARGUMENT_LENGTH - bytes.size());
+            return ARGUMENT_LENGTH;
+        }
+
+        writeSlot(buffer, bytes.data(), bytes.size());
         return ARGUMENT_LENGTH;
     }
 
-    std::vector<uint8_t> ABIEncoder::Encode(const EncodableItem *item) const
+    size_t ABIEncoder::EncodedSize(const std::vector<EncodableItem> &items) const
     {
-        std::vector<uint8_t> encoded(getVectorSize(item), 0);
+        size_t size = 0;
+        for (const EncodableItem &item : items)
+        {
+            size += IsDynamic(&item) ? ARGUMENT_LENGTH + EncodedSize(&item) : EncodedSize(&item);
+        }
+        return size;
+    }
 
-        if (leftPad(item->Type()))
+    size_t ABIEncoder::Write(const std::vector<EncodableItem> &items, uint8_t *buffer) const
+    {
+        size_t head = 0;
+        for (const EncodableItem &item : items)
         {
-            pad(&encoded, item->Bytes());
-        } 
-        else if (item->Type() == EncodableItemType::Binary || item->Type() == EncodableItemType::String)
+            head += IsDynamic(&item) ? ARGUMENT_LENGTH : EncodedSize(&item);
+        }
+
+        // Static values are written in the head, dynamic values in the tail with their offset in the head.
+        size_t position = 0;
+        size_t tail = head;
+        for (const EncodableItem &item : items)
         {
-            pad(&encoded, item->Bytes().size() | byte_array::size_to_bytes);
-            for(size_t i = 0; i < item->Bytes().size(); i++)
+            if (IsDynamic(&item))
+            {
+                writeSize(buffer + position, tail);
+                tail += Write(&item, buffer + tail);
+                position += ARGUMENT_LENGTH;
+            }
+            else
             {
-                encoded[ARGUMENT_LENGTH + i] = item->Bytes()[i];
+                position += Write(&item, buffer + position);
             }
-        } 
-        else if (item->Type() == EncodableItemType::ItemArray) 
+        }
+        return tail;
+    }
+
+    /// @brief Returns the packed width of an integer item (e.g. 1 for "uint8", 32 for "uint" or "int256").
+    static size_t packedIntegerLength(const EncodableItem *item)
+    {
+        const char *handle = item->Handle();
+        const size_t prefix = item->Type() == EncodableItemType::SignedInt ? 3 : 4;
+        size_t length = strlen(handle) < prefix ? 0 : (handle[prefix] == '\0' ? 256 : atoi(handle + prefix)) / 8;
+        if (length == 0 || length > ARGUMENT_LENGTH)
         {
-            std::vector<uint8_t> sizeAsBytes = item->Children().size() | byte_array::size_to_bytes;
-            pad(&encoded, sizeAsBytes);
-            size_t j;
-            for (size_t i = 0; i < item->Children().size(); i++)
+            THROW("Invalid integer type for packed encoding.");
+        }
+        return length;
+    }
+
+    static size_t packedLength(const EncodableItem *item)
+    {
+        switch (item->Type())
+        {
+        case EncodableItemType::UnsignedInt:
+        case EncodableItemType::SignedInt:
+            return packedIntegerLength(item);
+        case EncodableItemType::Bool:
+            return 1;
+        case EncodableItemType::Address:
+            return 20;
+        case EncodableItemType::ItemArray:
+        case EncodableItemType::FixedArray:
+            // Like `abi.encodePacked`, only arrays of elementary types are supported, each element taking one 32-byte slot.
+            for (const EncodableItem &child : item->Children())
             {
-                j = 0;
-                for (const uint8_t b : Encode(&(item->Children().at(i))))
+                if (child.IsList() || ABIEncoder::IsDynamic(&child))
                 {
-                    encoded[ARGUMENT_LENGTH + j + i * ARGUMENT_LENGTH] = b;
-                    j++;
+                    THROW("Packed encoding of arrays with non-elementary or dynamic elements is not supported.");
                 }
             }
+            return ARGUMENT_LENGTH * item->Children().size();
+        case EncodableItemType::FixedBytes:
+            return atoi(item->Handle() + 5);
+        case EncodableItemType::Tuple:
+            THROW("Tuples can't be packed encoded.");
+            return 0;
+        default:
+            return item->Bytes().size();
         }
+    }
+
+    std::vector<uint8_t> ABIEncoder::EncodePacked(const std::vector<EncodableItem> &items) const
+    {
+        std::vector<uint8_t> encoded(PackedSize(items));
+        WritePacked(items, encoded.data());
         return encoded;
     }
 
-}
\ No newline at end of file
+    size_t ABIEncoder::PackedSize(const std::vector<EncodableItem> &items) const
+    {
+        size_t size = 0;
+        for (const EncodableItem &item : items)
+        {
+            size += packedLength(&item);
+        }
+        return size;
+    }
+
+    size_t ABIEncoder::WritePacked(const std::vector<EncodableItem> &items, uint8_t *buffer) const
+    {
+        size_t position = 0;
+        for (const EncodableItem &item : items)
+        {
+            const size_t length = packedLength(&item);
+            if (item.IsList())
+            {
+                // Array elements keep their 32-byte slots (`packedLength` only accepts elementary elements).
+                for (const EncodableItem &child : item.Children())
+                {
+                    Write(&child, buffer + position);
+                    position += ARGUMENT_LENGTH;
+                }
+                continue;
+            }
+
+            const ByteView bytes = item.Bytes();
+            if (item.Type() == EncodableItemType::SignedInt)
+            {
+                // Stored as 32-byte two's complement: keep the least significant bytes.
+                memcpy(buffer + position, bytes.data() + bytes.size() - length, length);
+            }
+            else if (item.Type() == EncodableItemType::Binary || item.Type() == EncodableItemType::String || item.Type() == EncodableItemType::FixedBytes)
+            {
+                memcpy(buffer + position, bytes.data(), bytes.size());
+                memset(buffer + position + bytes.size(), 0, length - bytes.size());
+            }
+            else
+            {
+                if (bytes.size() > length)
+                {
+                    THROW("Value exceeds the width of its type.");
+                }
+                memset(buffer + position, 0, length - bytes.size());
+                memcpy(buffer + position + length - bytes.size(), bytes.data(), bytes.size());
+            }
+            position += length;
+        }
+        return position;
+    }
+}
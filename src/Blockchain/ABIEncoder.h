@@ -45,6 +45,51 @@ namespace blockchain
         /// @return a hex-array representation of the encoded arguments.
         std::vector<uint8_t> Encode(const EncodableItem *item) const override;
 
+        /// @brief Returns the exact number of bytes `Encode(item)` will produce.
+        /// @param item
+        /// @return
+        size_t EncodedSize(const EncodableItem *item) const;
+
+        /// @brief Encodes `item` directly into `buffer`.
+        /// @param item
+        /// @param buffer Destination. Must be able to hold `EncodedSize(item)` bytes.
+        /// @return The number of bytes written.
+        size_t Write(const EncodableItem *item, uint8_t *buffer) const;
+
+        /// @brief Returns the exact number of bytes required to encode `items` as a tuple (e.g. function arguments).
+        /// @param items
+        /// @return
+        size_t EncodedSize(const std::vector<EncodableItem> &items) const;
+
+        /// @brief Encodes `items` as a tuple (static values and offsets in the head, dynamic content in the tail) directly into `buffer`.
+        /// @param items
+        /// @param buffer Destination. Must be able to hold `EncodedSize(items)` bytes.
+        /// @return The number of bytes written.
+        size_t Write(const std::vector<EncodableItem> &items, uint8_t *buffer) const;
+
+        /// @brief Encodes `items` using the non-standard packed mode (Solidity's `abi.encodePacked`): values use the width of their type 
+        /// (e.g. 1 byte for `uint8`, 20 bytes for `address`), `bytes` and `string` are not padded and array elements are padded to 32 bytes.
+        /// Tuples and arrays of arrays, tuples, `bytes` or `string` are rejected, as in Solidity.
+        /// @param items
+        /// @return
+        std::vector<uint8_t> EncodePacked(const std::vector<EncodableItem> &items) const;
+
+        /// @brief Returns the exact number of bytes `EncodePacked(items)` will produce.
+        /// @param items
+        /// @return
+        size_t PackedSize(const std::vector<EncodableItem> &items) const;
+
+        /// @brief Encodes `items` in packed mode directly into `buffer`.
+        /// @param items
+        /// @param buffer Destination. Must be able to hold `PackedSize(items)` bytes.
+        /// @return The number of bytes written.
+        size_t WritePacked(const std::vector<EncodableItem> &items, uint8_t *buffer) const;
+
+        /// @brief Returns `true` if `item` is of a dynamic type (i.e. encoded in the tail and referenced by an offset).
+        /// @param item
+        /// @return
+        static bool IsDynamic(const EncodableItem *item);
+
     };
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,192 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2023 Tord Wessman
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "ABIType.h"
+
+namespace blockchain
+{
+    static void skipSpaces(const char *&cursor)
+    {
+        while (*cursor == ' ') { cursor++; }
+    }
+
+    static bool isIdentifierChar(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    }
+
+    /// @brief Parses the decimal number in `[begin, end)`. Returns 0 if empty, malformed or too large.
+    static uint32_t parseNumber(const char *begin, const char *end)
+    {
+        if (begin == end || end - begin > 5) { return 0; }
+        uint32_t value = 0;
+        for (const char *c = begin; c < end; c++)
+        {
+            if (*c < '0' || *c > '9') { return 0; }
+            value = value * 10 + (*c - '0');
+        }
+        return value;
+    }
+
+    ABIType::ABIType() : kind(ABITypeKind::Tuple), size(0), dynamic(false), headSize(0) {}
+
+    Result<ABIType> ABIType::Parse(const char *types)
+    {
+        if (types == nullptr)
+        {
+            return Result<ABIType>::Err(ABI_TYPE_PARSE_ERROR, "Missing type signature.");
+        }
+
+        const char *cursor = types;
+        ABIType tuple;
+        if (!ParseList(cursor, '\0', tuple))
+        {
+            return Result<ABIType>::Err(ABI_TYPE_PARSE_ERROR, "Malformed type signature.");
+        }
+        return tuple;
+    }
+
+    bool ABIType::ParseList(const char *&cursor, char terminator, ABIType &tuple)
+    {
+        skipSpaces(cursor);
+        if (*cursor == terminator)
+        {
+            return true;
+        }
+
+        while (true)
+        {
+            ABIType component;
+            if (!ParseType(cursor, component)) { return false; }
+            tuple.components.push_back(component);
+
+            skipSpaces(cursor);
+            if (*cursor == terminator) { break; }
+            if (*cursor != ',') { return false; }
+            cursor++;
+        }
+
+        tuple.UpdateLayout();
+        return true;
+    }
+
+    bool ABIType::ParseType(const char *&cursor, ABIType &type)
+    {
+        skipSpaces(cursor);
+        if (*cursor == '(')
+        {
+            cursor++;
+            type = ABIType();
+            if (!ParseList(cursor, ')', type) || type.components.empty()) { return false; }
+            cursor++;
+        }
+        else
+        {
+            const char *begin = cursor;
+            while (isIdentifierChar(*cursor)) { cursor++; }
+            if (!ParseElementary(begin, cursor - begin, type)) { return false; }
+        }
+
+        while (*cursor == '[')
+        {
+            const char *begin = ++cursor;
+            while (*cursor >= '0' && *cursor <= '9') { cursor++; }
+            if (*cursor != ']') { return false; }
+
+            ABIType array(begin == cursor ? ABITypeKind::Array : ABITypeKind::FixedArray, 0);
+            if (array.kind == ABITypeKind::FixedArray)
+            {
+                uint32_t length = parseNumber(begin, cursor);
+                if (length == 0 || length > UINT16_MAX) { return false; }
+                array.size = length;
+            }
+            cursor++;
+
+            array.components.push_back(type);
+            array.UpdateLayout();
+            type = array;
+        }
+
+        // Skip an optional parameter name (e.g. "uint256 amount").
+        skipSpaces(cursor);
+        while (isIdentifierChar(*cursor)) { cursor++; }
+        return true;
+    }
+
+    bool ABIType::ParseElementary(const char *name, size_t length, ABIType &type)
+    {
+        const char *end = name + length;
+        if (length == 7 && strncmp(name, "address", 7) == 0) { type = ABIType(ABITypeKind::Address, 160); return true; }
+        if (length == 4 && strncmp(name, "bool", 4) == 0) { type = ABIType(ABITypeKind::Bool, 8); return true; }
+        if (length == 6 && strncmp(name, "string", 6) == 0) { type = ABIType(ABITypeKind::String, 0); return true; }
+        if (length == 5 && strncmp(name, "bytes", 5) == 0) { type = ABIType(ABITypeKind::Bytes, 0); return true; }
+
+        if (length > 5 && strncmp(name, "bytes", 5) == 0)
+        {
+            uint32_t bytes = parseNumber(name + 5, end);
+            if (bytes == 0 || bytes > 32) { return false; }
+            type = ABIType(ABITypeKind::FixedBytes, bytes);
+            return true;
+        }
+
+        ABITypeKind kind;
+        const char *bits;
+        if (length >= 4 && strncmp(name, "uint", 4) == 0) { kind = ABITypeKind::UnsignedInt; bits = name + 4; }
+        else if (length >= 3 && strncmp(name, "int", 3) == 0) { kind = ABITypeKind::SignedInt; bits = name + 3; }
+        else { return false; }
+
+        uint32_t size = bits == end ? 256 : parseNumber(bits, end);
+        if (size == 0 || size > 256 || size % 8 != 0) { return false; }
+        type = ABIType(kind, size);
+        return true;
+    }
+
+    void ABIType::UpdateLayout()
+    {
+        switch (kind)
+        {
+        case ABITypeKind::Array:
+            dynamic = true;
+            headSize = 32;
+            break;
+        case ABITypeKind::FixedArray:
+            dynamic = components[0].dynamic;
+            headSize = dynamic ? 32 : size * components[0].headSize;
+            break;
+        case ABITypeKind::Tuple:
+            dynamic = false;
+            headSize = 0;
+            for (const ABIType &component : components)
+            {
+                dynamic = dynamic || component.dynamic;
+                headSize += component.headSize;
+            }
+            if (dynamic) { headSize = 32; }
+            break;
+        default:
+            break;
+        }
+    }
+}
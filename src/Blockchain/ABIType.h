@@ -0,0 +1,97 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2023 Tord Wessman
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef __ABI_TYPE_H__
+#define __ABI_TYPE_H__
+
+#include <vector>
+#include <stdint.h>
+
+#include "../Shared/Common.h"
+
+namespace blockchain
+{
+    #define ABI_TYPE_PARSE_ERROR -51
+
+    /// @brief The kinds of types supported by the ABI specification.
+    enum class ABITypeKind
+    {
+        UnsignedInt,
+        SignedInt,
+        Bool,
+        Address,
+        FixedBytes,
+        Bytes,
+        String,
+        Array,
+        FixedArray,
+        Tuple
+    };
+
+    /// @brief A parsed ABI type (e.g. `uint256`, `bytes32`, `address[]` or `(string,uint8)[2]`).
+    class ABIType
+    {
+    public:
+        /// @brief Creates an empty tuple.
+        ABIType();
+
+        /// @brief Parses a comma-separated list of types into a tuple, using the same convention as Solidity's `abi.decode(data, (...))`.
+        /// Function results should be parsed this way, e.g. `"uint256,string"` for `returns (uint256, string)`.
+        /// @param types 
+        /// @return The tuple or `ABI_TYPE_PARSE_ERROR` if `types` is malformed.
+        static Result<ABIType> Parse(const char *types);
+
+        /// @brief Returns the kind of this type.
+        ABITypeKind Kind() const { return kind; }
+
+        /// @brief Returns the number of bits for integers, the number of bytes for `bytesN` and the length for `T[k]`.
+        uint16_t Size() const { return size; }
+
+        /// @brief Returns the components of a tuple or the (single) element type of an array.
+        const std::vector<ABIType> &Components() const { return components; }
+
+        /// @brief Returns true if the encoded size of the type depends on its value.
+        bool IsDynamic() const { return dynamic; }
+
+        /// @brief Returns the number of bytes this type occupies in the head of an enclosing tuple.
+        size_t HeadSize() const { return headSize; }
+
+    private:
+        ABIType(ABITypeKind kind, uint16_t size) : kind(kind), size(size), dynamic(kind == ABITypeKind::Bytes || kind == ABITypeKind::String), headSize(32) {}
+
+        static bool ParseList(const char *&cursor, char terminator, ABIType &tuple);
+        static bool ParseType(const char *&cursor, ABIType &type);
+        static bool ParseElementary(const char *name, size_t length, ABIType &type);
+        void UpdateLayout();
+
+        ABITypeKind kind;
+        uint16_t size;
+        std::vector<ABIType> components;
+        bool dynamic;
+        size_t headSize;
+    };
+}
+
+#endif
@@ -43,7 +43,7 @@ namespace blockchain
             memset(address, '0', sizeof(address));
             address[0] = '0';
             address[1] = 'x';
-            address[sizeof(address)] = '\0';
+            address[ETH_ADDRESS_LENGTH] = '\0';
         }
 
         /// @brief Create an `Address` using the last `ETH_ADDRESS_LENGTH` bytes.
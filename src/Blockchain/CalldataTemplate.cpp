@@ -0,0 +1,157 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2023 Tord Wessman
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstring>
+#include <cstdlib>
+
+#include "CalldataTemplate.h"
+
+namespace blockchain
+{
+    /// @brief Returns the width of an integer handle (e.g. 8 for "uint8", 256 for "uint" or "int256").
+    static uint16_t integerBits(const EncodableItem &item)
+    {
+        if (item.Type() != EncodableItemType::UnsignedInt && item.Type() != EncodableItemType::SignedInt)
+        {
+            return 0;
+        }
+        const char *handle = item.Handle();
+        const size_t prefix = item.Type() == EncodableItemType::SignedInt ? 3 : 4;
+        return strlen(handle) <= prefix ? 256 : (uint16_t)atoi(handle + prefix);
+    }
+
+    /// @brief Returns true if the encoded integer `word` fits in `bits` bits, i.e. all bits above are zero (or a sign extension).
+    static bool fitsInBits(const uint8_t *word, uint16_t bits, bool isSigned)
+    {
+        const size_t unused = 32 - bits / 8;
+        const uint8_t padding = isSigned && (word[unused] & 0x80) ? 0xFF : 0;
+        for (size_t i = 0; i < unused; i++)
+        {
+            if (word[i] != padding) { return false; }
+        }
+        return true;
+    }
+
+    CalldataTemplate::CalldataTemplate(const ContractCall &call) : data(call.AsData())
+    {
+        const std::vector<EncodableItem> &arguments = call.Arguments();
+        slots.reserve(arguments.size());
+
+        size_t offset = KECCAK256_SIGNATURE_SIZE;
+        for (const EncodableItem &argument : arguments)
+        {
+            const bool dynamic = ABIEncoder::IsDynamic(&argument);
+            const size_t length = dynamic ? 0 : encoder.EncodedSize(&argument);
+            slots.push_back({offset, length, argument.Type(), integerBits(argument), argument.Handle()});
+            offset += dynamic ? 32 : length;
+        }
+    }
+
+    const CalldataTemplate::Slot &CalldataTemplate::SlotAt(size_t index) const
+    {
+        if (index >= slots.size())
+        {
+            THROW("Argument index out of range.");
+        }
+        return slots[index];
+    }
+
+    const CalldataTemplate::Slot &CalldataTemplate::IntegerSlotAt(size_t index) const
+    {
+        const Slot &slot = SlotAt(index);
+        if (slot.bits == 0)
+        {
+            THROW("Argument is not an integer.");
+        }
+        return slot;
+    }
+
+    void CalldataTemplate::Set(size_t index, const EncodableItem &value)
+    {
+        const Slot &slot = SlotAt(index);
+        if (slot.length == 0)
+        {
+            THROW("Dynamic arguments can't be replaced in a template.");
+        }
+        // Integer handles are compared by width, so that e.g. "uint" matches "uint256".
+        const bool sameType = slot.bits != 0 ? integerBits(value) == slot.bits : slot.handle == value.Handle();
+        if (value.Type() != slot.type || !sameType || ABIEncoder::IsDynamic(&value) || encoder.EncodedSize(&value) != slot.length)
+        {
+            THROW("Value does not match the type of the argument.");
+        }
+        if (slot.bits != 0)
+        {
+            uint8_t word[32];
+            encoder.Write(&value, word);
+            if (!fitsInBits(word, slot.bits, slot.type == EncodableItemType::SignedInt))
+            {
+                THROW("Value out of range for the argument's integer type.");
+            }
+            memcpy(data.data() + slot.offset, word, sizeof(word));
+            return;
+        }
+        encoder.Write(&value, data.data() + slot.offset);
+    }
+
+    void CalldataTemplate::Set(size_t index, const BigNumber &value)
+    {
+        const Slot &slot = IntegerSlotAt(index);
+        const bool isSigned = slot.type == EncodableItemType::SignedInt;
+        if (!value.FitsInBits(slot.bits, isSigned))
+        {
+            THROW("Value out of range for the argument's integer type.");
+        }
+
+        uint8_t (&word)[32] = *reinterpret_cast<uint8_t (*)[32]>(data.data() + slot.offset);
+        if (isSigned)
+        {
+            value.WriteTwosComplement(word);
+        }
+        else
+        {
+            value.WriteBigEndian(word);
+        }
+    }
+
+    void CalldataTemplate::Set(size_t index, uint64_t value)
+    {
+        const Slot &slot = IntegerSlotAt(index);
+        if (slot.bits < 64 && (value >> slot.bits) != 0)
+        {
+            THROW("Value out of range for the argument's integer type.");
+        }
+        if (slot.type == EncodableItemType::SignedInt && slot.bits <= 64 && (value >> (slot.bits - 1)) != 0)
+        {
+            THROW("Value out of range for the argument's integer type.");
+        }
+
+        uint8_t *word = data.data() + slot.offset;
+        memset(word, 0, 24);
+        for (size_t i = 0; i < 8; i++)
+        {
+            word[31 - i] = (uint8_t)(value >> (i * 8));
+        }
+    }
+}
@@ -0,0 +1,98 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2023 Tord Wessman
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef __CALLDATA_TEMPLATE_H__
+#define __CALLDATA_TEMPLATE_H__
+
+#include <vector>
+#include <string>
+#include <stdint.h>
+
+#include "../Shared/Common.h"
+#include "../Shared/BigNumber.h"
+#include "Contract.h"
+#include "Encodable.h"
+
+namespace blockchain
+{
+    /// @brief Call data that is encoded once and then updated in place. Useful when the same function is called repeatedly with
+    /// only a few arguments changing (e.g. an amount or a deadline): the selector is not rehashed and the call is not re-encoded.
+    /// Only static arguments (integers, addresses, bools, `bytesN` and static tuples/fixed-size arrays) can be replaced.
+    class CalldataTemplate
+    {
+    public:
+        /// @brief Encodes `call` and records the position of each argument.
+        /// @param call A call created with a function name or a selector (and arguments).
+        explicit CalldataTemplate(const ContractCall &call);
+
+        /// @brief Returns the number of arguments in the template.
+        size_t ArgumentCount() const { return slots.size(); }
+
+        /// @brief Returns `true` if the argument at `index` is static and can be replaced.
+        bool IsPatchable(size_t index) const { return index < slots.size() && slots[index].length > 0; }
+
+        /// @brief Returns the position of the argument at `index` in `Data()`.
+        size_t Offset(size_t index) const { return SlotAt(index).offset; }
+
+        /// @brief Replaces a static argument. `value` must have the same type handle as the original argument and, for integers,
+        /// fit in its width.
+        void Set(size_t index, const EncodableItem &value);
+
+        /// @brief Replaces an integer argument. Throws if `value` does not fit in the argument's `uintN`/`intN` type.
+        void Set(size_t index, const BigNumber &value);
+
+        /// @brief Replaces an unsigned integer argument. Throws if `value` does not fit in the argument's `uintN` type.
+        void Set(size_t index, uint64_t value);
+
+        /// @brief Returns the current call data (the selector followed by the encoded arguments).
+        const std::vector<uint8_t> &Data() const { return data; }
+
+        /// @brief Returns a `ContractCall` using a copy of the current call data.
+        ContractCall Call() const { return ContractCall(data); }
+
+    private:
+        struct Slot
+        {
+            /// @brief Position in `data`.
+            size_t offset;
+            /// @brief The number of bytes occupied by the argument, or 0 for dynamic arguments.
+            size_t length;
+            EncodableItemType type;
+            /// @brief The width of integer arguments.
+            uint16_t bits;
+            /// @brief The type handle of the argument (e.g. "address" or "(uint8,bool)").
+            std::string handle;
+        };
+
+        const Slot &SlotAt(size_t index) const;
+        const Slot &IntegerSlotAt(size_t index) const;
+
+        std::vector<uint8_t> data;
+        std::vector<Slot> slots;
+        ABIEncoder encoder;
+    };
+}
+
+#endif
@@ -23,10 +23,17 @@
  */
 
 #include "Chain.h"
+#include "TransactionBuilder.h"
 #include "../Network/HttpRequest.h"
 #include "../Shared/R2Web3Log.h"
 #include "Internal/Chain_ethRequest.h"
 
+#include <cstdio>
+#include <memory>
+#ifdef R2WEB3_THREADING_SUPPORTED
+#include <thread>
+#endif
+
 namespace blockchain
 {
     bool Chain::Start()
@@ -64,7 +71,8 @@ namespace blockchain
 
     Result<BigNumber> Chain::GetBalance(const Address address, const Address contractAddress) const
     {
-        ContractCall getBalanceCall("balanceOf", {ENC(address)});
+        // Selector of `balanceOf(address)`.
+        ContractCall getBalanceCall({0x70, 0xa0, 0x82, 0x31}, {ENC(address)});
         Result<TransactionResponse> result = ViewCall(address, contractAddress, &getBalanceCall);
         if (result.HasValue())
         {
@@ -155,30 +163,76 @@ namespace blockchain
                                             const BigNumber amount, const uint32_t gasLimit,
                                             const BigNumber *gasPrice, const ContractCall *contractCall) const
     {
-        Result<BigNumber> nonceResult = GetTransactionCount(from->GetAddress());
+        // The nonce and the gas price are fetched at once.
+        TransactionBuilder builder(this);
+        builder.From(from->GetAddress()).To(to).Value(amount).GasLimit(gasLimit);
+        if (gasPrice != nullptr)
+        {
+            builder.GasPrice(*gasPrice);
+        }
+        if (contractCall != nullptr)
+        {
+            builder.Call(*contractCall);
+        }
 
-        if (!nonceResult.HasValue())
+        Result<EthereumTransaction *> built = builder.Build();
+        if (!built.HasValue())
         {
-            return Result<TransactionResponse>::Err(-1, "Unable to retrieve nonce.");
+            return Result<TransactionResponse>::Err(built);
         }
 
-        uint32_t nonce = nonceResult.Value().ToUInt32();
+        // The built transaction is signed as it is, so its fields are not encoded again.
+        std::unique_ptr<EthereumTransaction> unsignedTransaction(built.Value());
+        std::vector<uint8_t> privateKey = from->GetPrivateKey();
+        EthereumTransaction transaction = transactionFactory->SignTransaction(std::move(*unsignedTransaction), &privateKey);
 
-        BigNumber gp(gasPrice);
+        char *parameter = transaction.SerializeHexString();
+        Result<char *> result = MakeRequst("eth_sendRawTransaction", {cJSON_CreateStringReference(parameter)});
+        delete[] parameter;
 
-        if (gasPrice == nullptr)
+        if (result.HasValue())
         {
-            Result<BigNumber> gasPriceResult = GetGasPrice();
-            if (!gasPriceResult.HasValue())
-            {
-                return Result<TransactionResponse>::Err(-41, "Unable to fetch gas price.");
-            }
-            gp = gasPriceResult.Value();
+            return Result<TransactionResponse>(result.Value());
         }
+        return Result<TransactionResponse>::Err(result);
+    }
 
-        char *parameter = transactionFactory->GenerateSerializedData(EthereumTransactionProperties(nonce, gp, gasLimit, to, amount, (contractCall ? contractCall->AsData() : std::vector<uint8_t>()), id), from);
+    Result<TransactionResponse> Chain::Send(const Account *from, const EthereumTransactionProperties &properties) const
+    {
+        char *parameter = transactionFactory->GenerateSerializedData(properties, from);
         
-        Result<char *> result = MakeRequst("eth_sendRawTransaction", {cJSON_CreateString(parameter)});
+        // Referenced rather than copied by cJSON.
+        Result<char *> result = MakeRequst("eth_sendRawTransaction", {cJSON_CreateStringReference(parameter)});
+        delete[] parameter;
+
+        if (result.HasValue())
+        {
+            return Result<TransactionResponse>(result.Value());
+        }
+        return Result<TransactionResponse>::Err(result);
+    }
+
+    Result<TransactionResponse> Chain::Send(const Account *from, const EthereumTransactionProperties &properties, SignedTransactionStore *store) const
+    {
+        std::vector<uint8_t> privateKey = from->GetPrivateKey();
+        EthereumTransaction transaction = transactionFactory->GenerateTransaction(properties, &privateKey);
+        store->Add(transaction, from->GetAddress());
+
+        char *parameter = transaction.SerializeHexString();
+        Result<char *> result = MakeRequst("eth_sendRawTransaction", {cJSON_CreateStringReference(parameter)});
+        delete[] parameter;
+
+        if (result.HasValue())
+        {
+            return Result<TransactionResponse>(result.Value());
+        }
+        return Result<TransactionResponse>::Err(result);
+    }
+
+    Result<TransactionResponse> Chain::SendRawTransaction(const std::vector<uint8_t> &raw) const
+    {
+        char *parameter = (raw | byte_array::hex_string) | char_string::add_hex_prefix;
+        Result<char *> result = MakeRequst("eth_sendRawTransaction", {cJSON_CreateStringReference(parameter)});
         delete[] parameter;
 
         if (result.HasValue())
@@ -188,40 +242,120 @@ namespace blockchain
         return Result<TransactionResponse>::Err(result);
     }
 
+    size_t Chain::Rebroadcast(const SignedTransactionStore *store) const
+    {
+        size_t accepted = 0;
+        for (const StoredTransaction &transaction : store->Pending())
+        {
+            // Nodes reject transactions they already know about, which is expected for most of them.
+            if (SendRawTransaction(transaction.raw).HasValue())
+            {
+                accepted++;
+            }
+        }
+        return accepted;
+    }
+
+    Result<size_t> Chain::RemoveConfirmed(SignedTransactionStore *store) const
+    {
+        size_t removed = 0;
+        for (const Address &sender : store->Senders())
+        {
+            Result<BigNumber> countResult = GetTransactionCount(sender);
+            if (!countResult.HasValue())
+            {
+                return Result<size_t>::Err(countResult);
+            }
+            removed += store->RemoveConfirmed(sender, countResult.Value().ToUInt32());
+        }
+        return removed;
+    }
+
+    /// @brief Writes `value` as a JSON-RPC quantity ("0x"-prefixed, without leading zeros).
+    static void writeQuantity(const BigNumber &value, char *buffer, size_t length)
+    {
+        buffer[0] = '0';
+        buffer[1] = 'x';
+        size_t written = value.WriteHexString(buffer + 2, length - 2);
+        size_t leadingZeros = 0;
+        while (leadingZeros + 1 < written && buffer[2 + leadingZeros] == '0')
+        {
+            leadingZeros++;
+        }
+        if (written == 0)
+        {
+            buffer[2] = '0';
+            buffer[3] = '\0';
+        }
+        else if (leadingZeros > 0)
+        {
+            memmove(buffer + 2, buffer + 2 + leadingZeros, written - leadingZeros + 1);
+        }
+    }
+
     Result<BigNumber> Chain::EstimateGas(const Account *from, const Address to,
                                          const BigNumber amount, const uint32_t gasLimit,
                                          const BigNumber *gasPrice, const ContractCall *contractCall) const
     {
-        Result<BigNumber> nonceResult = GetTransactionCount(from->GetAddress());
+        return RequestGasEstimate(from->GetAddress(), to, amount, (contractCall ? contractCall->AsData() : std::vector<uint8_t>()), gasLimit, gasPrice);
+    }
 
-        if (!nonceResult.HasValue())
+    Result<BigNumber> Chain::EstimateGas(const Address &from, const Address &to, const BigNumber &value, const std::vector<uint8_t> &data,
+                                         GasEstimateCache *cache) const
+    {
+        if (cache == nullptr)
         {
-            return Result<BigNumber>::Err(-1, "Unable to retrieve nonce.");
+            return RequestGasEstimate(from, to, value, data, 0, nullptr);
         }
 
-        uint32_t nonce = nonceResult.Value().ToUInt32();
+        uint32_t gasLimit;
+        if (cache->Find(to, data, !value.IsZero(), gasLimit))
+        {
+            return BigNumber(gasLimit);
+        }
 
-        BigNumber gp(gasPrice);
+        Result<BigNumber> estimate = RequestGasEstimate(from, to, value, data, 0, nullptr);
+        if (!estimate.HasValue())
+        {
+            return estimate;
+        }
+        return BigNumber(cache->Insert(to, data, !value.IsZero(), estimate.Value().ToUInt32()));
+    }
 
-        if (gasPrice == nullptr)
+    Result<BigNumber> Chain::RequestGasEstimate(const Address &from, const Address &to, const BigNumber &value, const std::vector<uint8_t> &data, 
+                                                uint32_t gasLimit, const BigNumber *gasPrice) const
+    {
+        // The call object of `eth_estimateGas` (like `eth_call`): the transaction is neither signed nor does it need a nonce.
+        char quantity[2 + BIG_NUMBER_MAX_WORDS * 4 + 1];
+        cJSON *callCJson = cJSON_CreateObject();
+        cJSON_AddStringToObject(callCJson, "from", from.AsString());
+        cJSON_AddStringToObject(callCJson, "to", to.AsString());
+        writeQuantity(value, quantity, sizeof(quantity));
+        cJSON_AddStringToObject(callCJson, "value", quantity);
+        if (gasLimit > 0)
         {
-            Result<BigNumber> gasPriceResult = GetGasPrice();
-            if (!gasPriceResult.HasValue())
-            {
-                return Result<BigNumber>::Err(-41, "Unable to fetch gas price.");
-            }
-            gp = gasPriceResult.Value();
+            writeQuantity(BigNumber(gasLimit), quantity, sizeof(quantity));
+            cJSON_AddStringToObject(callCJson, "gas", quantity);
+        }
+        if (gasPrice != nullptr)
+        {
+            writeQuantity(*gasPrice, quantity, sizeof(quantity));
+            cJSON_AddStringToObject(callCJson, "gasPrice", quantity);
+        }
+        if (!data.empty())
+        {
+            char *dataAsHexString = (data | byte_array::hex_string) | char_string::add_hex_prefix;
+            cJSON_AddStringToObject(callCJson, "data", dataAsHexString);
+            delete[] dataAsHexString;
         }
 
-        char *parameter = transactionFactory->GenerateSerializedData(EthereumTransactionProperties(nonce, gp, gasLimit, to, amount, (contractCall ? contractCall->AsData() : std::vector<uint8_t>()), id), from);
-        Result<char *> result = MakeRequst("eth_estimateGas", {cJSON_CreateString(parameter)});
-        delete[] parameter;
+        Result<char *> result = MakeRequst("eth_estimateGas", {callCJson});
 
         if (result.HasValue())
         {
-            Result<BigNumber> gasPrice(result.Value());
+            BigNumber gas(result.Value());
             delete[] result.Value();
-            return gasPrice;
+            return gas;
         }
         return Result<BigNumber>::Err(result);
     }
@@ -240,6 +374,54 @@ namespace blockchain
         return Result<BigNumber>::Err(result);
     }
 
+    Result<FeeSuggestion> Chain::SuggestFees(uint8_t blockCount, uint8_t rewardPercentile) const
+    {
+        char count[2 + 2 + 1];
+        snprintf(count, sizeof(count), "0x%x", blockCount);
+        cJSON *percentiles = cJSON_CreateArray();
+        cJSON_AddItemToArray(percentiles, cJSON_CreateNumber(rewardPercentile));
+
+        Result<char *> result = MakeRequst("eth_feeHistory", {cJSON_CreateString(count), cJSON_CreateString("latest"), percentiles});
+        if (!result.HasValue())
+        {
+            return Result<FeeSuggestion>::Err(result);
+        }
+
+        cJSON *json = result.Value() != nullptr ? cJSON_Parse(result.Value()) : nullptr;
+        free(result.Value());
+        cJSON *baseFees = cJSON_GetObjectItemCaseSensitive(json, "baseFeePerGas");
+        cJSON *nextBaseFee = cJSON_IsArray(baseFees) ? cJSON_GetArrayItem(baseFees, cJSON_GetArraySize(baseFees) - 1) : nullptr;
+        if (!cJSON_IsString(nextBaseFee))
+        {
+            cJSON_Delete(json);
+            return Result<FeeSuggestion>::Err(-41, "Invalid eth_feeHistory result.");
+        }
+
+        // The last entry of `baseFeePerGas` is the base fee of the next block.
+        FeeSuggestion fees;
+        fees.baseFeePerGas = BigNumber(nextBaseFee->valuestring);
+
+        std::vector<BigNumber> rewards;
+        cJSON *blockRewards;
+        cJSON_ArrayForEach(blockRewards, cJSON_GetObjectItemCaseSensitive(json, "reward"))
+        {
+            cJSON *reward = cJSON_GetArrayItem(blockRewards, 0);
+            if (cJSON_IsString(reward))
+            {
+                rewards.push_back(BigNumber(reward->valuestring));
+            }
+        }
+        cJSON_Delete(json);
+
+        if (!rewards.empty())
+        {
+            std::sort(rewards.begin(), rewards.end());
+            fees.maxPriorityFeePerGas = rewards[rewards.size() / 2];
+        }
+        fees.maxFeePerGas = fees.baseFeePerGas * BigNumber(2u) + fees.maxPriorityFeePerGas;
+        return fees;
+    }
+
     Result<BigNumber> Chain::GetBalance(const Address address) const
     {
         Result<char *> result = MakeRequst("eth_getBalance", {cJSON_CreateString(address.AsString()), cJSON_CreateString("latest")});
@@ -254,6 +436,297 @@ namespace blockchain
         return Result<BigNumber>::Err(result);
     }
 
+    Result<uint64_t> Chain::GetBlockNumber() const
+    {
+        Result<char *> result = MakeRequst("eth_blockNumber", {});
+
+        if (result.HasValue())
+        {
+            uint64_t blockNumber = strtoull(result.Value(), nullptr, 16);
+            delete[] result.Value();
+            return blockNumber;
+        }
+
+        return Result<uint64_t>::Err(result);
+    }
+
+    /// @brief Returns true if a provider rejected an `eth_getLogs` request because the result would be too large.
+    /// Other errors (including rate limits and quotas, which splitting the range would only make worse) are not matched.
+    static bool isLogLimitError(const ErrorDescription &error)
+    {
+        if (error.ErrorCode() == -32005)
+        {
+            return true;
+        }
+
+        const char *message = error.ErrorMessage();
+        for (const char *hint : {"query returned more than", "block range is too large", "response size exceeded"})
+        {
+            if (strstr(message, hint) != nullptr)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief Parses an `eth_getLogs` result (deallocating `json`) and delivers each log to `callback`.
+    static Result<size_t> deliverLogs(char *json, const std::function<bool(const EventLog &log)> &callback, bool &stopped)
+    {
+        if (json == nullptr)
+        {
+            return Result<size_t>(0);
+        }
+
+        cJSON *logs = cJSON_Parse(json);
+        free(json);
+        if (!cJSON_IsArray(logs))
+        {
+            cJSON_Delete(logs);
+            return Result<size_t>::Err(-41, "Invalid eth_getLogs result.");
+        }
+
+        size_t count = 0;
+        cJSON *item;
+        cJSON_ArrayForEach(item, logs)
+        {
+            Result<EventLog *> log = EventLog::Parse(item);
+            if (!log.HasValue())
+            {
+                cJSON_Delete(logs);
+                return Result<size_t>::Err(log);
+            }
+
+            count++;
+            bool proceed = callback(*log.Value());
+            delete log.Value();
+            if (!proceed)
+            {
+                stopped = true;
+                break;
+            }
+        }
+        cJSON_Delete(logs);
+        return count;
+    }
+
+    Result<char *> Chain::RequestLogs(const LogFilter &filter, uint64_t fromBlock, uint64_t toBlock) const
+    {
+        cJSON *filterCJson = cJSON_CreateObject();
+        char blockNumber[2 + 16 + 1];
+        snprintf(blockNumber, sizeof(blockNumber), "0x%llx", (unsigned long long)fromBlock);
+        cJSON_AddStringToObject(filterCJson, "fromBlock", blockNumber);
+        snprintf(blockNumber, sizeof(blockNumber), "0x%llx", (unsigned long long)toBlock);
+        cJSON_AddStringToObject(filterCJson, "toBlock", blockNumber);
+
+        if (!filter.addresses.empty())
+        {
+            cJSON *addresses = cJSON_AddArrayToObject(filterCJson, "address");
+            for (const Address &address : filter.addresses)
+            {
+                cJSON_AddItemToArray(addresses, cJSON_CreateString(address.AsString()));
+            }
+        }
+
+        if (!filter.topics.empty())
+        {
+            cJSON *topics = cJSON_AddArrayToObject(filterCJson, "topics");
+            for (const std::vector<std::vector<uint8_t>> &alternatives : filter.topics)
+            {
+                if (alternatives.empty())
+                {
+                    cJSON_AddItemToArray(topics, cJSON_CreateNull());
+                    continue;
+                }
+
+                cJSON *position = cJSON_CreateArray();
+                for (const std::vector<uint8_t> &topic : alternatives)
+                {
+                    char *topicString = (topic | byte_array::hex_string) | char_string::add_hex_prefix;
+                    cJSON_AddItemToArray(position, cJSON_CreateString(topicString));
+                    delete[] topicString;
+                }
+                cJSON_AddItemToArray(topics, position);
+            }
+        }
+
+        return MakeRequst("eth_getLogs", {filterCJson});
+    }
+
+    Result<size_t> Chain::GetLogsInRange(const LogFilter &filter, uint64_t fromBlock, uint64_t toBlock,
+                                         const std::function<bool(const EventLog &log)> &callback, bool &stopped) const
+    {
+        Result<char *> result = RequestLogs(filter, fromBlock, toBlock);
+        if (result.HasValue())
+        {
+            return deliverLogs(result.Value(), callback, stopped);
+        }
+        if (fromBlock == toBlock || !isLogLimitError(result))
+        {
+            return Result<size_t>::Err(result);
+        }
+
+        uint64_t middle = fromBlock + (toBlock - fromBlock) / 2;
+        Result<size_t> first = GetLogsInRange(filter, fromBlock, middle, callback, stopped);
+        if (!first.HasValue() || stopped)
+        {
+            return first;
+        }
+        Result<size_t> second = GetLogsInRange(filter, middle + 1, toBlock, callback, stopped);
+        if (!second.HasValue())
+        {
+            return second;
+        }
+        return first.Value() + second.Value();
+    }
+
+    Result<size_t> Chain::GetLogs(const LogFilter &filter, std::function<bool(const EventLog &log)> callback) const
+    {
+        AssertStarted();
+
+        uint64_t toBlock = filter.toBlock;
+        if (toBlock == LOG_FILTER_LATEST_BLOCK)
+        {
+            Result<uint64_t> latest = GetBlockNumber();
+            if (!latest.HasValue())
+            {
+                return Result<size_t>::Err(latest);
+            }
+            toBlock = latest.Value();
+        }
+
+        uint64_t blockRange = filter.blockRange > 0 ? filter.blockRange : 1;
+        size_t concurrency = 1;
+    #ifdef R2WEB3_THREADING_SUPPORTED
+        if (network->IsThreadSafe() && filter.concurrency > 1)
+        {
+            concurrency = filter.concurrency;
+        }
+    #endif
+
+        size_t delivered = 0;
+        bool stopped = false;
+        uint64_t fromBlock = filter.fromBlock;
+
+        bool done = fromBlock > toBlock;
+
+        while (!done && !stopped)
+        {
+            std::vector<std::pair<uint64_t, uint64_t>> ranges;
+            while (ranges.size() < concurrency && !done)
+            {
+                uint64_t last = toBlock - fromBlock < blockRange ? toBlock : fromBlock + blockRange - 1;
+                ranges.push_back(std::make_pair(fromBlock, last));
+                done = last == toBlock;
+                fromBlock = last + 1;
+            }
+
+            std::vector<Result<char *>> results(ranges.size(), Result<char *>(nullptr));
+    #ifdef R2WEB3_THREADING_SUPPORTED
+            std::vector<std::thread> threads;
+            for (size_t i = 1; i < ranges.size(); i++)
+            {
+                threads.push_back(std::thread([this, &filter, &ranges, &results, i]() {
+                    results[i] = RequestLogs(filter, ranges[i].first, ranges[i].second);
+                }));
+            }
+            results[0] = RequestLogs(filter, ranges[0].first, ranges[0].second);
+            for (std::thread &thread : threads)
+            {
+                thread.join();
+            }
+    #else
+            results[0] = RequestLogs(filter, ranges[0].first, ranges[0].second);
+    #endif
+
+            Result<size_t> failure = Result<size_t>(0);
+            for (size_t i = 0; i < ranges.size(); i++)
+            {
+                if (stopped || !failure.HasValue())
+                {
+                    // Discard results fetched ahead of a stop or a failure.
+                    if (results[i].HasValue() && results[i].Value() != nullptr) { free(results[i].Value()); }
+                    continue;
+                }
+
+                Result<size_t> count = Result<size_t>(0);
+                if (results[i].HasValue())
+                {
+                    count = deliverLogs(results[i].Value(), callback, stopped);
+                }
+                else if (isLogLimitError(results[i]))
+                {
+                    // Use smaller ranges from now on and split the rejected one.
+                    blockRange = blockRange > 1 ? blockRange / 2 : 1;
+                    count = GetLogsInRange(filter, ranges[i].first, ranges[i].second, callback, stopped);
+                }
+                else
+                {
+                    count = Result<size_t>::Err(results[i]);
+                }
+
+                if (count.HasValue())
+                {
+                    delivered += count.Value();
+                }
+                else
+                {
+                    failure = count;
+                }
+            }
+
+            if (!failure.HasValue())
+            {
+                return failure;
+            }
+        }
+
+        return delivered;
+    }
+
+    /// @brief Decodes `log` as `event`, whose indexed parameters follow the first `skip` bytes of the topics.
+    static bool decodeEvent(const ABIEvent *event, const EventLog &log, size_t skip, DecodedEvent &decoded)
+    {
+        if (log.topics.size() - skip != event->indexedInputs.Components().size() * EVENT_TOPIC_SIZE)
+        {
+            return false;
+        }
+        Result<ABIValue> indexed = event->DecodeTopics(log.topics.data() + skip, log.topics.size() - skip);
+        Result<ABIValue> data = event->DecodeData(&log.data);
+        if (!indexed.HasValue() || !data.HasValue())
+        {
+            return false;
+        }
+        decoded.event = event;
+        decoded.indexed = indexed.Value();
+        decoded.data = data.Value();
+        return true;
+    }
+
+    Result<size_t> Chain::GetLogs(const LogFilter &filter, const ContractABI *abi, std::function<bool(const DecodedEvent &event)> callback) const
+    {
+        return GetLogs(filter, [abi, &callback](const EventLog &log) {
+            DecodedEvent decoded;
+            decoded.log = &log;
+            decoded.event = nullptr;
+
+            const ABIEvent *event = log.TopicCount() > 0 ? abi->EventByTopic(log.Topic(0)) : nullptr;
+            if (event != nullptr)
+            {
+                decodeEvent(event, log, EVENT_TOPIC_SIZE, decoded);
+            }
+            else
+            {
+                // Anonymous events emit no event topic, so the first one whose parameters fit the log is used.
+                for (size_t index : abi->AnonymousEvents())
+                {
+                    if (decodeEvent(&abi->Events()[index], log, 0, decoded)) { break; }
+                }
+            }
+            return callback(decoded);
+        });
+    }
+
     Result<char *> Chain::MakeRequst(const char* method, const std::vector<cJSON *> parameters, const bool assertStarted) const {
 
         if (assertStarted) {
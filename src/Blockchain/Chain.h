@@ -26,6 +26,7 @@
 #define __CHAIN_H__
 
 #include <vector>
+#include <functional>
 #include <stdint.h>
 
 #include "../Shared/Common.h"
@@ -38,9 +39,18 @@
 #include "Contract.h"
 #include "TransactionFactory.h"
 #include "EthereumTransactionFactory.h"
+#include "EventLog.h"
+#include "SignedTransactionStore.h"
+#include "GasEstimateCache.h"
 
 namespace blockchain
 {
+    /// Default number of blocks sampled by `Chain::SuggestFees`.
+    #define FEE_HISTORY_BLOCK_COUNT 10
+
+    /// Default priority fee percentile used by `Chain::SuggestFees`.
+    #define FEE_HISTORY_REWARD_PERCENTILE 50
+
     /// @brief Interface to a EVM-compatible blockchain.
     class Chain
     {
@@ -56,8 +66,11 @@ namespace blockchain
         }
 
         bool Start();
-        bool Started() { return started; }
-        uint32_t Id() { return id; }
+        bool Started() const { return started; }
+        uint32_t Id() const { return id; }
+
+        /// @brief Returns `true` if requests can be made from multiple threads at once.
+        bool IsThreadSafe() const { return network->IsThreadSafe(); }
 
         /// @brief Manually set the RPC URL
         /// @param newUrl
@@ -67,22 +80,40 @@ namespace blockchain
         /// @return 
         Result<uint32_t> LoadChainId() const;
 
-        /// @brief Returns the estimated gas price for a transaction
+        /// @brief Returns the gas required by a transaction, estimated using `eth_estimateGas` (without signing it).
         /// @param from
         /// @param to
         /// @param amount
-        /// @param gasPrice
-        /// @param gasLimit
+        /// @param gasLimit The maximum gas to consider or 0 to let the node decide.
+        /// @param gasPrice Optional parameter. Gas price, used by the node to check the balance of `from`.
         /// @param contractCall a `ContractCall` object for an RPC invocation or `nullptr` for a transaction. 
-        /// @return The estimated gas fee for a transaction
+        /// @return The estimated gas for a transaction
         Result<BigNumber> EstimateGas(const Account *from, const Address to,
                                       const BigNumber amount, const uint32_t gasLimit,
                                       const BigNumber *gasPrice = nullptr, const ContractCall *contractCall = nullptr) const;
 
+        /// @brief Returns the gas required by a transaction, estimated using `eth_estimateGas` (without signing it).
+        /// @param from
+        /// @param to
+        /// @param value
+        /// @param data Call data or an empty vector for a transfer.
+        /// @param cache Optional parameter. If provided, the gas limit (including the cache's safety margin) of a call with the same shape is 
+        /// returned without a request, and new estimates are cached and returned including the margin.
+        /// @return
+        Result<BigNumber> EstimateGas(const Address &from, const Address &to, const BigNumber &value, const std::vector<uint8_t> &data,
+                                      GasEstimateCache *cache = nullptr) const;
+
         /// @brief Return the current gas price.
         /// @return Base gas price
         Result<BigNumber> GetGasPrice() const;
 
+        /// @brief Suggests EIP-1559 fees using `eth_feeHistory`: the priority fee is the median of the `rewardPercentile`th
+        /// percentile priority fee of the last `blockCount` blocks and `maxFeePerGas` allows the base fee to double.
+        /// @param blockCount
+        /// @param rewardPercentile
+        /// @return
+        Result<FeeSuggestion> SuggestFees(uint8_t blockCount = FEE_HISTORY_BLOCK_COUNT, uint8_t rewardPercentile = FEE_HISTORY_REWARD_PERCENTILE) const;
+
         /// @brief Returns the balance (in gwei) for the provided `account`.
         /// @param account 
         /// @return
@@ -118,6 +149,35 @@ namespace blockchain
                                         const BigNumber amount, const uint32_t gasLimit,
                                         const BigNumber *gasPrice = nullptr, const ContractCall *contractCall = nullptr) const;
 
+        /// @brief Signs and sends a transaction of any type (see `EthereumTransactionProperties::EIP1559` and `EIP2930`).
+        /// @param from Sender account
+        /// @param properties The complete transaction, including nonce, fees and chain id.
+        /// @return The result of the transaction.
+        Result<TransactionResponse> Send(const Account *from, const EthereumTransactionProperties &properties) const;
+
+        /// @brief Signs a transaction, records it in `store` and sends it. The transaction is recorded before it is sent,
+        /// so that it can be rebroadcasted (see `Rebroadcast`) if sending fails or the process is restarted.
+        /// @param from Sender account
+        /// @param properties The complete transaction, including nonce, fees and chain id.
+        /// @param store
+        /// @return The result of the transaction.
+        Result<TransactionResponse> Send(const Account *from, const EthereumTransactionProperties &properties, SignedTransactionStore *store) const;
+
+        /// @brief Sends a serialized signed transaction.
+        /// @param raw
+        /// @return The result of the transaction.
+        Result<TransactionResponse> SendRawTransaction(const std::vector<uint8_t> &raw) const;
+
+        /// @brief Sends the transactions of `store` again (ordered by sender and nonce), e.g. after they have been dropped from the mempool.
+        /// @param store
+        /// @return The number of transactions accepted by the node.
+        size_t Rebroadcast(const SignedTransactionStore *store) const;
+
+        /// @brief Removes the transactions of `store` that have been mined (or replaced), based on the transaction count of their senders.
+        /// @param store
+        /// @return The number of transactions removed.
+        Result<size_t> RemoveConfirmed(SignedTransactionStore *store) const;
+
         /// @brief Returns a transaction `TransactionReceipt` for the specified transaction or `nullptr` if no transaction was found.
         /// @param transactionHash
         /// @return `TransactionReceipt` or nullptr if no transaction was found.
@@ -128,6 +188,26 @@ namespace blockchain
         /// @return `BlockInformation` or nullptr if no block was found.
         Result<BlockInformation*> GetBlockInformation(const char *blockHash) const;
 
+        /// @brief Returns the number of the most recent block.
+        /// @return
+        Result<uint64_t> GetBlockNumber() const;
+
+        /// @brief Streams the logs matching `filter` to `callback` in block order. The block range is fetched in chunks of
+        /// `filter.blockRange` blocks (split further if the provider rejects a chunk for returning too many results),
+        /// so only `filter.concurrency` chunks are held in memory at a time.
+        /// @param filter
+        /// @param callback Invoked for each log. Return `false` to stop.
+        /// @return The number of logs delivered to `callback`.
+        Result<size_t> GetLogs(const LogFilter &filter, std::function<bool(const EventLog &log)> callback) const;
+
+        /// @brief Streams the logs matching `filter` to `callback`, decoded using the events of `abi`.
+        /// Logs without a matching event are delivered with `DecodedEvent::event` set to `nullptr`.
+        /// @param filter
+        /// @param abi
+        /// @param callback Invoked for each log. Return `false` to stop.
+        /// @return The number of logs delivered to `callback`.
+        Result<size_t> GetLogs(const LogFilter &filter, const ContractABI *abi, std::function<bool(const DecodedEvent &event)> callback) const;
+
     private:
         const EthereumTransactionFactory *transactionFactory;
         char *url;
@@ -135,6 +215,11 @@ namespace blockchain
         uint32_t id;
         bool started;
         void AssertStarted() const;
+        Result<char *> RequestLogs(const LogFilter &filter, uint64_t fromBlock, uint64_t toBlock) const;
+        Result<size_t> GetLogsInRange(const LogFilter &filter, uint64_t fromBlock, uint64_t toBlock, 
+                                      const std::function<bool(const EventLog &log)> &callback, bool &stopped) const;
+        Result<BigNumber> RequestGasEstimate(const Address &from, const Address &to, const BigNumber &value, const std::vector<uint8_t> &data, 
+                                             uint32_t gasLimit, const BigNumber *gasPrice) const;
         Result<char *> MakeRequst(const char* method, const std::vector<cJSON *> parameters, const bool assertStarted = true) const;
 
     };
@@ -27,116 +27,184 @@
 
 #include "../Shared/Common.h"
 
+#include <list>
+#include <unordered_map>
+
+#ifdef R2WEB3_THREADING_SUPPORTED
+#include <mutex>
+#endif
+
 namespace blockchain
 {
-    #define ARGUMENT_LENGTH 32
-
-    void ContractCall::GenerateSignatureHash()
+    /// @brief A process-wide, least-recently-used cache of function selectors keyed by the hash of their canonical signature.
+    /// Signatures are hashed and compared piece by piece, so a lookup does not build the signature string.
+    class SelectorCache
     {
-        size_t signature_size = 2 + strlen(functionName);
-
-        for (auto argument : arguments)
+    public:
+        /// @brief FNV-1a of the signature `functionName(handle,handle,...)`.
+        static uint32_t Hash(const char *functionName, const std::vector<EncodableItem> &arguments)
         {
-            signature_size += 1 + strlen(argument.Handle());
+            uint32_t hash = 2166136261u;
+            hash = Hash(hash, functionName);
+            hash = Hash(hash, '(');
+            for (size_t i = 0; i < arguments.size(); i++)
+            {
+                if (i > 0) { hash = Hash(hash, ','); }
+                hash = Hash(hash, arguments[i].Handle());
+            }
+            return Hash(hash, ')');
         }
-        if (arguments.size() > 0)
+
+        /// @brief Copies the selector of the signature with `hash` to `selector` and returns true if it has been cached.
+        bool Find(uint32_t hash, const char *functionName, const std::vector<EncodableItem> &arguments, uint8_t *selector)
         {
-            signature_size -= 1;
+    #ifdef R2WEB3_THREADING_SUPPORTED
+            std::lock_guard<std::mutex> lock(mutex);
+    #endif
+            auto entry = entries.find(hash);
+            if (entry == entries.end() || !Matches(entry->second.signature, functionName, arguments))
+            {
+                return false;
+            }
+            recent.splice(recent.begin(), recent, entry->second.position);
+            memcpy(selector, entry->second.selector, KECCAK256_SIGNATURE_SIZE);
+            return true;
         }
 
-        std::vector<uint8_t> signatureVector(signature_size);
-        std::vector<uint8_t> functionNameVector = functionName | byte_array::string_to_bytes;
-        size_t i = 0;
-        for(uint8_t b : (functionName | byte_array::string_to_bytes))
+        /// @brief Caches the selector of `signature`, evicting the least recently used selector if the cache is full.
+        /// A different signature with the same hash is replaced.
+        void Insert(uint32_t hash, std::vector<uint8_t> &&signature, const uint8_t *selector)
         {
-            signatureVector[i] = b;
-            i++;
+    #ifdef R2WEB3_THREADING_SUPPORTED
+            std::lock_guard<std::mutex> lock(mutex);
+    #endif
+            auto existing = entries.find(hash);
+            if (existing != entries.end())
+            {
+                recent.erase(existing->second.position);
+                entries.erase(existing);
+            }
+            else if (entries.size() >= SELECTOR_CACHE_CAPACITY)
+            {
+                entries.erase(recent.back());
+                recent.pop_back();
+            }
+            recent.push_front(hash);
+            Entry &entry = entries[hash];
+            entry.signature = std::move(signature);
+            entry.position = recent.begin();
+            memcpy(entry.selector, selector, KECCAK256_SIGNATURE_SIZE);
         }
-        signatureVector[i] = '(';
 
-        i++;
+    private:
+        struct Entry
+        {
+            std::vector<uint8_t> signature;
+            uint8_t selector[KECCAK256_SIGNATURE_SIZE];
+            std::list<uint32_t>::iterator position;
+        };
 
-        for (size_t j = 0; j < arguments.size(); j++)
+        static uint32_t Hash(uint32_t hash, uint8_t b) { return (hash ^ b) * 16777619u; }
+
+        static uint32_t Hash(uint32_t hash, const char *s)
+        {
+            for (; *s != '\0'; s++) { hash = Hash(hash, (uint8_t)*s); }
+            return hash;
+        }
+
+        /// @brief Compares `piece` with `signature` at `position`, advancing `position` past it on a match.
+        static bool Consume(const std::vector<uint8_t> &signature, size_t &position, const char *piece, size_t length)
         {
-            for (uint8_t b : arguments[j].Handle() | byte_array::string_to_bytes)
+            if (signature.size() - position < length || memcmp(signature.data() + position, piece, length) != 0)
             {
-                signatureVector[i] = b;
-                i++;
+                return false;
             }
+            position += length;
+            return true;
+        }
 
-            if (j < arguments.size() - 1) 
-            { 
-                signatureVector[i] = ',';
-                i++; 
+        static bool Matches(const std::vector<uint8_t> &signature, const char *functionName, const std::vector<EncodableItem> &arguments)
+        {
+            size_t position = 0;
+            if (!Consume(signature, position, functionName, strlen(functionName)) || !Consume(signature, position, "(", 1))
+            {
+                return false;
+            }
+            for (size_t i = 0; i < arguments.size(); i++)
+            {
+                if (i > 0 && !Consume(signature, position, ",", 1)) { return false; }
+                if (!Consume(signature, position, arguments[i].Handle(), strlen(arguments[i].Handle()))) { return false; }
             }
+            return Consume(signature, position, ")", 1) && position == signature.size();
         }
 
-        signatureVector[i] = ')';
-        std::vector<uint8_t> hash = Keccak256(&signatureVector, KECCAK256_SIGNATURE_SIZE);
-        signatureHash.insert(signatureHash.begin(), hash.begin(), hash.end());
-    }
+        std::unordered_map<uint32_t, Entry> entries;
+        /// Hashes of the cached signatures, most recently used first.
+        std::list<uint32_t> recent;
+    #ifdef R2WEB3_THREADING_SUPPORTED
+        std::mutex mutex;
+    #endif
+    };
 
-    void padx(std::vector<uint8_t> *argument, const std::vector<uint8_t> &value, const bool left = true, const size_t argumentLength = ARGUMENT_LENGTH)
+    static SelectorCache &selectorCache()
     {
-        assert(value.size() <= argumentLength);
-        size_t start = argumentLength - value.size();
-        for (size_t i = 0; i < value.size(); i++)
-        {
-            if (left) { argument->at(start - i) = value.at(value.size() - i - 1); }
-            else { argument->at(i) = value.at(i); }
-        }
+        static SelectorCache cache;
+        return cache;
     }
 
-    bool isDynamic(const EncodableItem *argument)
+    void ContractCall::GenerateSignatureHash()
     {
-        return argument->Type() == EncodableItemType::ItemArray ||
-               argument->Type() == EncodableItemType::Binary ||
-               argument->Type() == EncodableItemType::String;
-    }
+        signatureHash.resize(KECCAK256_SIGNATURE_SIZE);
+        uint32_t hash = SelectorCache::Hash(functionName, arguments);
+        if (selectorCache().Find(hash, functionName, arguments, signatureHash.data()))
+        {
+            return;
+        }
 
-    std::vector<uint8_t> ContractCall::AsData() const {
+        size_t signature_size = 2 + strlen(functionName);
 
-        std::vector<uint8_t> callData = signatureHash;
-        std::vector<std::vector<uint8_t>> params;
-        size_t dataPosition = 0;//callData.size();
-        for(size_t i = 0; i < arguments.size(); i++)
+        for (const EncodableItem &argument : arguments)
         {
-            params.push_back(encoder.Encode(&arguments[i]));
-            if (isDynamic(&arguments[i]))
-            {
-                dataPosition += ARGUMENT_LENGTH;
-            }
-            else
-            {
-                dataPosition += params[i].size();
-            }
+            signature_size += 1 + strlen(argument.Handle());
+        }
+        if (arguments.size() > 0)
+        {
+            signature_size -= 1;
         }
 
-        size_t currentPosition = 0;
-        
-        for (size_t i = 0; i < arguments.size(); i++)
+        std::vector<uint8_t> signatureVector;
+        signatureVector.reserve(signature_size);
+        signatureVector.insert(signatureVector.end(), functionName, functionName + strlen(functionName));
+        signatureVector.push_back('(');
+
+        for (size_t j = 0; j < arguments.size(); j++)
         {
-            if (isDynamic(&arguments[i]))
-            {
-                std::vector<uint8_t> positionVector(ARGUMENT_LENGTH, 0);
-                padx(&positionVector, dataPosition | byte_array::size_to_bytes);
-                callData.insert(callData.end(), positionVector.begin(), positionVector.end());
-                dataPosition += params[i].size();
-            } 
-            else
-            {
-                callData.insert(callData.end(), params[i].begin(), params[i].end());
+            const char *handle = arguments[j].Handle();
+            signatureVector.insert(signatureVector.end(), handle, handle + strlen(handle));
+
+            if (j < arguments.size() - 1) 
+            { 
+                signatureVector.push_back(',');
             }
         }
 
-        for (size_t i = 0; i < arguments.size(); i++)
+        signatureVector.push_back(')');
+
+        std::vector<uint8_t> selector = Keccak256(&signatureVector, KECCAK256_SIGNATURE_SIZE);
+        memcpy(signatureHash.data(), selector.data(), KECCAK256_SIGNATURE_SIZE);
+        selectorCache().Insert(hash, std::move(signatureVector), signatureHash.data());
+    }
+
+    std::vector<uint8_t> ContractCall::AsData() const 
+    {
+        if (!callData.empty())
         {
-            if (isDynamic(&arguments[i]))
-            {
-                callData.insert(callData.end(), params[i].begin(), params[i].end());
-            }
+            return callData;
         }
 
-        return callData;
+        std::vector<uint8_t> encoded(signatureHash.size() + encoder.EncodedSize(arguments));
+        memcpy(encoded.data(), signatureHash.data(), signatureHash.size());
+        encoder.Write(arguments, encoded.data() + signatureHash.size());
+        return encoded;
     }
 }
\ No newline at end of file
@@ -33,6 +33,10 @@ namespace blockchain
 {
     #define KECCAK256_SIGNATURE_SIZE 4
 
+    /// Maximum number of function selectors kept by the process-wide selector cache. Once it is full, each new signature
+    /// evicts the least recently used selector.
+    #define SELECTOR_CACHE_CAPACITY 64
+
     /// @brief A `ContractCall` is an object that represents a smart contract invocation and this object is passed as a parameter to 
     /// a `Chain.Send` or `Chain.ViewCall`.
     class ContractCall 
@@ -60,12 +64,34 @@ namespace blockchain
             GenerateSignatureHash();
         }
 
+        /// @brief Function call using a precomputed selector, which skips building and hashing the signature.
+        /// @param selector The first `KECCAK256_SIGNATURE_SIZE` bytes of the Keccak-256 hash of the function signature.
+        /// @param arguments See `ContractCall(const char *, const std::vector<EncodableItem>)`.
+        ContractCall(const std::vector<uint8_t> selector, const std::vector<EncodableItem> arguments) :
+                functionName(nullptr),
+                arguments(arguments),
+                signatureHash(selector)
+        {
+            if (selector.size() != KECCAK256_SIGNATURE_SIZE)
+            {
+                THROW("Invalid function selector size.");
+            }
+        }
+
+        /// @brief Call using precomputed call data (the selector followed by the encoded arguments), e.g. from `ContractFunction::Encode`.
+        /// @param callData
+        explicit ContractCall(const std::vector<uint8_t> callData) : functionName(nullptr), arguments({}), callData(callData) {}
+
         std::vector<uint8_t> AsData() const;
 
+        /// @brief Returns the arguments of the call. Empty if the call was created from precomputed call data.
+        const std::vector<EncodableItem> &Arguments() const { return arguments; }
+
     private:
         const char *functionName;
         const std::vector<EncodableItem> arguments;
         std::vector<uint8_t> signatureHash;
+        const std::vector<uint8_t> callData;
         void GenerateSignatureHash();
         ABIEncoder encoder;
     };
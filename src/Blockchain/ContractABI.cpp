@@ -0,0 +1,375 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2023 Tord Wessman
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "ContractABI.h"
+#include "Signer.h"
+
+#ifndef ARDUINO
+#include <cstdio>
+#endif
+
+namespace blockchain
+{
+    /// @brief FNV-1a hash used as key for name and signature lookups.
+    static uint32_t hashString(const char *string)
+    {
+        uint32_t hash = 2166136261u;
+        for (; *string != '\0'; string++)
+        {
+            hash = (hash ^ (uint8_t)*string) * 16777619u;
+        }
+        return hash;
+    }
+
+    /// @brief Uses the first four bytes of a selector or topic as key.
+    static uint32_t hashPrefix(const uint8_t *bytes)
+    {
+        return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) | ((uint32_t)bytes[2] << 8) | bytes[3];
+    }
+
+    static void append(std::vector<char> &string, const char *value)
+    {
+        string.insert(string.end(), value, value + strlen(value));
+    }
+
+    /// @brief Appends the canonical type of an ABI parameter (e.g. `(uint256,address)[]` for a `tuple[]`).
+    static bool appendCanonicalType(cJSON *parameter, std::vector<char> &string);
+
+    /// @brief Appends the comma-separated canonical types of a parameter list.
+    static bool appendCanonicalList(cJSON *parameters, std::vector<char> &string)
+    {
+        cJSON *parameter;
+        bool first = true;
+        cJSON_ArrayForEach(parameter, parameters)
+        {
+            if (!first) { string.push_back(','); }
+            if (!appendCanonicalType(parameter, string)) { return false; }
+            first = false;
+        }
+        return true;
+    }
+
+    static bool appendCanonicalType(cJSON *parameter, std::vector<char> &string)
+    {
+        cJSON *type = cJSON_GetObjectItemCaseSensitive(parameter, "type");
+        if (!cJSON_IsString(type))
+        {
+            return false;
+        }
+
+        const char *value = type->valuestring;
+        if (strncmp(value, "tuple", 5) == 0)
+        {
+            string.push_back('(');
+            if (!appendCanonicalList(cJSON_GetObjectItemCaseSensitive(parameter, "components"), string)) { return false; }
+            string.push_back(')');
+            value += 5;
+        }
+        append(string, value);
+        return true;
+    }
+
+    /// @brief Returns the hash of `string`.
+    static std::vector<uint8_t> hashSignature(const std::vector<char> &string, size_t length)
+    {
+        std::vector<uint8_t> bytes(string.begin(), string.end());
+        return Keccak256(&bytes, length);
+    }
+
+    ContractCall ABIFunction::Call(const std::vector<EncodableItem> arguments) const
+    {
+        if (arguments.size() != inputs.Components().size())
+        {
+            THROW("Invalid number of arguments for contract function.");
+        }
+        return ContractCall(std::vector<uint8_t>(selector, selector + KECCAK256_SIGNATURE_SIZE), arguments);
+    }
+
+    ContractABI::~ContractABI()
+    {
+        for (char *string : strings)
+        {
+            delete[] string;
+        }
+    }
+
+    Result<ContractABI *> ContractABI::Parse(const char *json)
+    {
+        cJSON *document = cJSON_Parse(json);
+        cJSON *items = document;
+
+        // Compiler artifacts (e.g. from Hardhat or Foundry) wrap the ABI in an object.
+        if (cJSON_IsObject(document))
+        {
+            items = cJSON_GetObjectItemCaseSensitive(document, "abi");
+        }
+
+        if (!cJSON_IsArray(items))
+        {
+            cJSON_Delete(document);
+            return Result<ContractABI *>::Err(CONTRACT_ABI_PARSE_ERROR, "ABI JSON is not an array.");
+        }
+
+        ContractABI *abi = new ContractABI();
+        cJSON *item;
+        cJSON_ArrayForEach(item, items)
+        {
+            cJSON *type = cJSON_GetObjectItemCaseSensitive(item, "type");
+            const char *kind = cJSON_IsString(type) ? type->valuestring : "function";
+            bool valid = true;
+
+            if (strcmp(kind, "function") == 0)
+            {
+                valid = abi->AddFunction(item);
+            }
+            else if (strcmp(kind, "event") == 0)
+            {
+                valid = abi->AddEvent(item);
+            }
+
+            if (!valid)
+            {
+                delete abi;
+                cJSON_Delete(document);
+                return Result<ContractABI *>::Err(CONTRACT_ABI_PARSE_ERROR, "Malformed function or event in ABI JSON.");
+            }
+        }
+
+        cJSON_Delete(document);
+        return abi;
+    }
+
+#ifndef ARDUINO
+    Result<ContractABI *> ContractABI::Load(const char *path)
+    {
+        FILE *file = fopen(path, "rb");
+        if (file == nullptr)
+        {
+            return Result<ContractABI *>::Err(CONTRACT_ABI_PARSE_ERROR, "Unable to open ABI file.");
+        }
+
+        std::vector<char> json;
+        char buffer[1024];
+        size_t count;
+        while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        {
+            json.insert(json.end(), buffer, buffer + count);
+        }
+        fclose(file);
+        json.push_back('\0');
+
+        return Parse(json.data());
+    }
+#endif
+
+    bool ContractABI::AddFunction(cJSON *item)
+    {
+        cJSON *name = cJSON_GetObjectItemCaseSensitive(item, "name");
+        if (!cJSON_IsString(name))
+        {
+            return false;
+        }
+
+        std::vector<char> inputs;
+        std::vector<char> outputs;
+        if (!appendCanonicalList(cJSON_GetObjectItemCaseSensitive(item, "inputs"), inputs) ||
+            !appendCanonicalList(cJSON_GetObjectItemCaseSensitive(item, "outputs"), outputs))
+        {
+            return false;
+        }
+
+        std::vector<char> signature;
+        append(signature, name->valuestring);
+        signature.push_back('(');
+        signature.insert(signature.end(), inputs.begin(), inputs.end());
+        signature.push_back(')');
+
+        inputs.push_back('\0');
+        outputs.push_back('\0');
+        Result<ABIType> inputsType = ABIType::Parse(inputs.data());
+        Result<ABIType> outputsType = ABIType::Parse(outputs.data());
+        if (!inputsType.HasValue() || !outputsType.HasValue())
+        {
+            return false;
+        }
+
+        ABIFunction function;
+        std::vector<uint8_t> hash = hashSignature(signature, KECCAK256_SIGNATURE_SIZE);
+        memcpy(function.selector, hash.data(), KECCAK256_SIGNATURE_SIZE);
+        function.inputs = inputsType.Value();
+        function.outputs = outputsType.Value();
+        function.name = Retain(std::vector<char>(name->valuestring, name->valuestring + strlen(name->valuestring)));
+        function.signature = Retain(signature);
+
+        size_t index = functions.size();
+        functions.push_back(function);
+        functionsByName.insert(std::make_pair(hashString(function.name), index));
+        functionsByName.insert(std::make_pair(hashString(function.signature), index));
+        functionsBySelector.insert(std::make_pair(hashPrefix(function.selector), index));
+        return true;
+    }
+
+    bool ContractABI::AddEvent(cJSON *item)
+    {
+        cJSON *name = cJSON_GetObjectItemCaseSensitive(item, "name");
+        if (!cJSON_IsString(name))
+        {
+            return false;
+        }
+
+        std::vector<char> signature;
+        std::vector<char> indexed;
+        std::vector<char> data;
+        append(signature, name->valuestring);
+        signature.push_back('(');
+
+        cJSON *parameter;
+        cJSON_ArrayForEach(parameter, cJSON_GetObjectItemCaseSensitive(item, "inputs"))
+        {
+            std::vector<char> type;
+            if (!appendCanonicalType(parameter, type))
+            {
+                return false;
+            }
+            if (signature.back() != '(') { signature.push_back(','); }
+            signature.insert(signature.end(), type.begin(), type.end());
+
+            if (!cJSON_IsTrue(cJSON_GetObjectItemCaseSensitive(parameter, "indexed")))
+            {
+                if (!data.empty()) { data.push_back(','); }
+                data.insert(data.end(), type.begin(), type.end());
+                continue;
+            }
+
+            // Only the hash of indexed strings, bytes, arrays and tuples is emitted.
+            type.push_back('\0');
+            Result<ABIType> parsed = ABIType::Parse(type.data());
+            if (!parsed.HasValue())
+            {
+                return false;
+            }
+            ABITypeKind kind = parsed.Value().Components()[0].Kind();
+            bool hashed = kind == ABITypeKind::String || kind == ABITypeKind::Bytes || kind == ABITypeKind::Array ||
+                          kind == ABITypeKind::FixedArray || kind == ABITypeKind::Tuple;
+
+            if (!indexed.empty()) { indexed.push_back(','); }
+            if (hashed) { append(indexed, "bytes32"); }
+            else { indexed.insert(indexed.end(), type.begin(), type.end() - 1); }
+        }
+        signature.push_back(')');
+
+        indexed.push_back('\0');
+        data.push_back('\0');
+        Result<ABIType> indexedType = ABIType::Parse(indexed.data());
+        Result<ABIType> dataType = ABIType::Parse(data.data());
+        if (!indexedType.HasValue() || !dataType.HasValue())
+        {
+            return false;
+        }
+
+        ABIEvent event;
+        std::vector<uint8_t> hash = hashSignature(signature, EVENT_TOPIC_SIZE);
+        memcpy(event.topic, hash.data(), EVENT_TOPIC_SIZE);
+        event.anonymous = cJSON_IsTrue(cJSON_GetObjectItemCaseSensitive(item, "anonymous"));
+        event.indexedInputs = indexedType.Value();
+        event.dataInputs = dataType.Value();
+        event.name = Retain(std::vector<char>(name->valuestring, name->valuestring + strlen(name->valuestring)));
+        event.signature = Retain(signature);
+
+        size_t index = events.size();
+        events.push_back(event);
+        eventsByName.insert(std::make_pair(hashString(event.name), index));
+        eventsByName.insert(std::make_pair(hashString(event.signature), index));
+        if (event.anonymous)
+        {
+            anonymousEvents.push_back(index);
+        }
+        else
+        {
+            eventsByTopic.insert(std::make_pair(hashPrefix(event.topic), index));
+        }
+        return true;
+    }
+
+    const char *ContractABI::Retain(const std::vector<char> &string)
+    {
+        char *retained = new char[string.size() + 1];
+        memcpy(retained, string.data(), string.size());
+        retained[string.size()] = '\0';
+        strings.push_back(retained);
+        return retained;
+    }
+
+    const ABIFunction *ContractABI::Function(const char *nameOrSignature) const
+    {
+        const ABIFunction *match = nullptr;
+        auto range = functionsByName.equal_range(hashString(nameOrSignature));
+        for (auto it = range.first; it != range.second; it++)
+        {
+            const ABIFunction &function = functions[it->second];
+            if ((strcmp(function.name, nameOrSignature) == 0 || strcmp(function.signature, nameOrSignature) == 0) &&
+                (match == nullptr || &function < match))
+            {
+                match = &function;
+            }
+        }
+        return match;
+    }
+
+    const ABIFunction *ContractABI::FunctionBySelector(const uint8_t *selector) const
+    {
+        auto it = functionsBySelector.find(hashPrefix(selector));
+        return it == functionsBySelector.end() ? nullptr : &functions[it->second];
+    }
+
+    const ABIEvent *ContractABI::Event(const char *nameOrSignature) const
+    {
+        const ABIEvent *match = nullptr;
+        auto range = eventsByName.equal_range(hashString(nameOrSignature));
+        for (auto it = range.first; it != range.second; it++)
+        {
+            const ABIEvent &event = events[it->second];
+            if ((strcmp(event.name, nameOrSignature) == 0 || strcmp(event.signature, nameOrSignature) == 0) &&
+                (match == nullptr || &event < match))
+            {
+                match = &event;
+            }
+        }
+        return match;
+    }
+
+    const ABIEvent *ContractABI::EventByTopic(const uint8_t *topic) const
+    {
+        auto range = eventsByTopic.equal_range(hashPrefix(topic));
+        for (auto it = range.first; it != range.second; it++)
+        {
+            if (memcmp(events[it->second].topic, topic, EVENT_TOPIC_SIZE) == 0)
+            {
+                return &events[it->second];
+            }
+        }
+        return nullptr;
+    }
+}
@@ -0,0 +1,161 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2023 Tord Wessman
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef __CONTRACT_ABI_H__
+#define __CONTRACT_ABI_H__
+
+#include <vector>
+#include <unordered_map>
+#include <stdint.h>
+
+#include "../Shared/Common.h"
+#include "../Shared/cJSON.h"
+#include "Contract.h"
+#include "ABIType.h"
+#include "ABIDecoder.h"
+
+namespace blockchain
+{
+    #define CONTRACT_ABI_PARSE_ERROR -53
+    #define EVENT_TOPIC_SIZE 32
+
+    /// @brief A function of a `ContractABI`.
+    struct ABIFunction
+    {
+        /// @brief The function name.
+        const char *name;
+
+        /// @brief The canonical signature, e.g. `transfer(address,uint256)`.
+        const char *signature;
+
+        /// @brief The first `KECCAK256_SIGNATURE_SIZE` bytes of the Keccak-256 hash of `signature`.
+        uint8_t selector[KECCAK256_SIGNATURE_SIZE];
+
+        /// @brief The parameters as a tuple.
+        ABIType inputs;
+
+        /// @brief The return values as a tuple.
+        ABIType outputs;
+
+        /// @brief Returns a `ContractCall` using the precomputed selector. `arguments` must match `inputs`.
+        ContractCall Call(const std::vector<EncodableItem> arguments) const;
+
+        /// @brief Decodes the raw result of a call. The value references `data`, which must outlive it.
+        Result<ABIValue> DecodeResult(const std::vector<uint8_t> *data) const { return ABIDecoder().Decode(&outputs, data); }
+    };
+
+    /// @brief An event of a `ContractABI`.
+    struct ABIEvent
+    {
+        /// @brief The event name.
+        const char *name;
+
+        /// @brief The canonical signature, e.g. `Transfer(address,address,uint256)`.
+        const char *signature;
+
+        /// @brief The Keccak-256 hash of `signature` (the first topic of non-anonymous events).
+        uint8_t topic[EVENT_TOPIC_SIZE];
+
+        /// @brief True if the event is declared `anonymous` (i.e. `topic` is not emitted).
+        bool anonymous;
+
+        /// @brief The indexed parameters as a tuple. Dynamic types are replaced by `bytes32`, since only their hash is emitted.
+        ABIType indexedInputs;
+
+        /// @brief The non-indexed parameters as a tuple.
+        ABIType dataInputs;
+
+        /// @brief Decodes the indexed parameters from the topics following the event topic, concatenated (32 bytes each).
+        Result<ABIValue> DecodeTopics(const uint8_t *topics, size_t length) const { return ABIDecoder().Decode(&indexedInputs, topics, length); }
+
+        /// @brief Decodes the non-indexed parameters from the log data. The value references `data`, which must outlive it.
+        Result<ABIValue> DecodeData(const std::vector<uint8_t> *data) const { return ABIDecoder().Decode(&dataInputs, data); }
+    };
+
+    /// @brief A contract description loaded from a Solidity ABI JSON document, with precomputed selectors and event topics.
+    class ContractABI
+    {
+    public:
+        ~ContractABI();
+
+        /// @brief Parses a Solidity ABI JSON document (the array emitted by `solc --abi`).
+        /// @param json
+        /// @return The description or `CONTRACT_ABI_PARSE_ERROR` if the document is malformed. Please note that the returned object needs to be deallocated manually.
+        static Result<ContractABI *> Parse(const char *json);
+
+    #ifndef ARDUINO
+        /// @brief Loads and parses a Solidity ABI JSON file.
+        /// @param path
+        /// @return See `Parse`.
+        static Result<ContractABI *> Load(const char *path);
+    #endif
+
+        /// @brief Returns the functions in declaration order.
+        const std::vector<ABIFunction> &Functions() const { return functions; }
+
+        /// @brief Returns the events in declaration order.
+        const std::vector<ABIEvent> &Events() const { return events; }
+
+        /// @brief Returns the function with the provided name or canonical signature, or `nullptr`. 
+        /// For overloaded functions, a lookup by name returns the first declared overload.
+        const ABIFunction *Function(const char *nameOrSignature) const;
+
+        /// @brief Returns the function with the provided `KECCAK256_SIGNATURE_SIZE`-byte selector, or `nullptr`.
+        const ABIFunction *FunctionBySelector(const uint8_t *selector) const;
+
+        /// @brief Returns the event with the provided name or canonical signature, or `nullptr`.
+        const ABIEvent *Event(const char *nameOrSignature) const;
+
+        /// @brief Returns the non-anonymous event with the provided `EVENT_TOPIC_SIZE`-byte topic, or `nullptr`.
+        const ABIEvent *EventByTopic(const uint8_t *topic) const;
+
+        /// @brief Returns the indices (into `Events()`) of the anonymous events, which are not indexed by topic since their
+        /// logs do not start with one.
+        const std::vector<size_t> &AnonymousEvents() const { return anonymousEvents; }
+
+    private:
+        ContractABI() {}
+        ContractABI(const ContractABI &) = delete;
+        ContractABI &operator=(const ContractABI &) = delete;
+
+        bool AddFunction(cJSON *item);
+        bool AddEvent(cJSON *item);
+        const char *Retain(const std::vector<char> &string);
+
+        std::vector<ABIFunction> functions;
+        std::vector<ABIEvent> events;
+
+        // Indices into `functions` and `events`, keyed by hashes of names, signatures, selectors and topics.
+        std::unordered_multimap<uint32_t, size_t> functionsByName;
+        std::unordered_map<uint32_t, size_t> functionsBySelector;
+        std::unordered_multimap<uint32_t, size_t> eventsByName;
+        std::unordered_multimap<uint32_t, size_t> eventsByTopic;
+        std::vector<size_t> anonymousEvents;
+
+        std::vector<char *> strings;
+    };
+}
+
+#endif
@@ -0,0 +1,256 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2023 Tord Wessman
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstring>
+
+#include "ContractAddress.h"
+#include "Encodable.h"
+#include "RlpEncoder.h"
+#include "Signer.h"
+#include "../cryptography/sha3.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+unsigned long millis();
+#endif
+
+#ifdef R2WEB3_THREADING_SUPPORTED
+#include <thread>
+#include <atomic>
+#endif
+
+#define ETH_ADDRESS_BYTES ((ETH_ADDRESS_LENGTH - 2) / 2)
+
+// 0xff || sender || salt || keccak256(initCode)
+#define CREATE2_INPUT_SIZE (1 + ETH_ADDRESS_BYTES + CREATE2_SALT_SIZE + KECCAK_256_LENGTH)
+#define CREATE2_SALT_OFFSET (1 + ETH_ADDRESS_BYTES)
+
+// The number of salts a mining thread tries between checking whether another thread has found one.
+#define CREATE2_MINING_BATCH 1024
+
+namespace blockchain
+{
+    /// @brief Returns the address formed by the last 20 bytes of `hash`.
+    static Address addressFromHash(const uint8_t *hash)
+    {
+        const char *digits = "0123456789abcdef";
+        char address[ETH_ADDRESS_LENGTH + 1] = { '0', 'x' };
+        for (size_t i = 0; i < ETH_ADDRESS_BYTES; i++)
+        {
+            uint8_t b = hash[KECCAK_256_LENGTH - ETH_ADDRESS_BYTES + i];
+            address[2 + i * 2] = digits[b >> 4];
+            address[3 + i * 2] = digits[b & 0x0F];
+        }
+        return Address(address);
+    }
+
+    /// @brief Writes `0xff || sender || salt || initCodeHash` to `input`.
+    static void writeCreate2Input(uint8_t *input, const Address &sender, const std::vector<uint8_t> &salt, const std::vector<uint8_t> &initCodeHash)
+    {
+        if (salt.size() != CREATE2_SALT_SIZE || initCodeHash.size() != KECCAK_256_LENGTH)
+        {
+            THROW("CREATE2 requires a 32-byte salt and a 32-byte init code hash.");
+        }
+        std::vector<uint8_t> senderBytes = sender.AsString() | byte_array::hex_string_to_bytes;
+        input[0] = 0xff;
+        memcpy(input + 1, senderBytes.data(), ETH_ADDRESS_BYTES);
+        memcpy(input + CREATE2_SALT_OFFSET, salt.data(), CREATE2_SALT_SIZE);
+        memcpy(input + CREATE2_SALT_OFFSET + CREATE2_SALT_SIZE, initCodeHash.data(), KECCAK_256_LENGTH);
+    }
+
+    Address CreateAddress(const Address &sender, uint64_t nonce)
+    {
+        // The nonce is encoded as a minimal big-endian integer (zero being empty).
+        std::vector<uint8_t> nonceBytes;
+        for (int shift = 56; shift >= 0; shift -= 8)
+        {
+            uint8_t b = (uint8_t)(nonce >> shift);
+            if (b != 0 || !nonceBytes.empty())
+            {
+                nonceBytes.push_back(b);
+            }
+        }
+
+        RlpEncoder encoder;
+        EncodableItem list({EncodableItem(sender), EncodableItem(std::move(nonceBytes))});
+        uint8_t encoded[1 + 1 + ETH_ADDRESS_BYTES + 1 + sizeof(uint64_t)];
+        size_t length = encoder.Write(&list, encoded);
+
+        uint8_t hash[KECCAK_256_LENGTH];
+        keccak_256(encoded, length, hash);
+        return addressFromHash(hash);
+    }
+
+    Address Create2Address(const Address &sender, const std::vector<uint8_t> &salt, const std::vector<uint8_t> &initCode)
+    {
+        return Create2AddressFromHash(sender, salt, Keccak256(&initCode));
+    }
+
+    Address Create2AddressFromHash(const Address &sender, const std::vector<uint8_t> &salt, const std::vector<uint8_t> &initCodeHash)
+    {
+        uint8_t input[CREATE2_INPUT_SIZE];
+        writeCreate2Input(input, sender, salt, initCodeHash);
+
+        uint8_t hash[KECCAK_256_LENGTH];
+        keccak_256(input, sizeof(input), hash);
+        return addressFromHash(hash);
+    }
+
+    /// @brief The prefix of a vanity address as nibbles.
+    struct NibblePrefix
+    {
+        uint8_t nibbles[ETH_ADDRESS_BYTES * 2];
+        size_t length;
+
+        /// @brief Returns `true` if the address formed by the last 20 bytes of `hash` starts with the prefix.
+        bool Matches(const uint8_t *hash) const
+        {
+            const uint8_t *address = hash + KECCAK_256_LENGTH - ETH_ADDRESS_BYTES;
+            for (size_t i = 0; i < length; i++)
+            {
+                uint8_t nibble = i % 2 == 0 ? address[i / 2] >> 4 : address[i / 2] & 0x0F;
+                if (nibble != nibbles[i])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    /// @brief Tries the salts `first`, `first + stride`, ... (stored in the last 8 bytes of the salt) until one matches, 
+    /// `count` salts have been tried or `found` is set.
+    static void mineSalts(uint8_t *input, const NibblePrefix &prefix, uint64_t first, uint64_t stride, uint64_t count,
+    #ifdef R2WEB3_THREADING_SUPPORTED
+                          std::atomic<bool> &found, std::atomic<uint64_t> &attempts,
+    #else
+                          bool &found, uint64_t &attempts,
+    #endif
+                          bool &matched)
+    {
+        // `input` is updated in place, so each attempt only hashes 85 bytes.
+        uint8_t *counter = input + CREATE2_SALT_OFFSET + CREATE2_SALT_SIZE - sizeof(uint64_t);
+        uint8_t hash[KECCAK_256_LENGTH];
+        uint64_t tried = 0;
+        uint64_t salt = first;
+        while (tried < count && !found)
+        {
+            uint64_t batch = count - tried < CREATE2_MINING_BATCH ? count - tried : CREATE2_MINING_BATCH;
+            for (uint64_t i = 0; i < batch; i++, salt += stride)
+            {
+                for (size_t b = 0; b < sizeof(uint64_t); b++)
+                {
+                    counter[b] = (uint8_t)(salt >> (56 - b * 8));
+                }
+                keccak_256(input, CREATE2_INPUT_SIZE, hash);
+                if (prefix.Matches(hash))
+                {
+                    attempts += i + 1;
+                    matched = true;
+                    found = true;
+                    return;
+                }
+            }
+            tried += batch;
+            attempts += batch;
+        }
+    }
+
+    Create2Salt MineCreate2Salt(const Address &sender, const std::vector<uint8_t> &initCodeHash, const char *prefix, uint64_t maxAttempts,
+                                uint8_t threads, const std::vector<uint8_t> &baseSalt)
+    {
+        NibblePrefix nibblePrefix;
+        string_info info = string_info(prefix) | char_string::remove_hex_prefix;
+        if (info.length > ETH_ADDRESS_BYTES * 2)
+        {
+            THROW("The prefix is longer than an address.");
+        }
+        nibblePrefix.length = info.length;
+        for (size_t i = 0; i < info.length; i++)
+        {
+            char c = info.value[info.begin + i];
+            if (c >= '0' && c <= '9') { nibblePrefix.nibbles[i] = c - '0'; }
+            else if (c >= 'a' && c <= 'f') { nibblePrefix.nibbles[i] = c - 'a' + 10; }
+            else if (c >= 'A' && c <= 'F') { nibblePrefix.nibbles[i] = c - 'A' + 10; }
+            else { THROW("The prefix must consist of hex digits."); }
+        }
+
+        uint8_t input[CREATE2_INPUT_SIZE];
+        writeCreate2Input(input, sender, baseSalt.empty() ? std::vector<uint8_t>(CREATE2_SALT_SIZE) : baseSalt, initCodeHash);
+
+        Create2Salt result;
+        result.found = false;
+        unsigned long start = millis();
+
+    #ifdef R2WEB3_THREADING_SUPPORTED
+        std::atomic<bool> found(false);
+        std::atomic<uint64_t> attempts(0);
+        size_t count = threads > 1 ? threads : 1;
+
+        // Each thread works on its own copy of the input.
+        std::vector<std::vector<uint8_t>> inputs(count, std::vector<uint8_t>(input, input + CREATE2_INPUT_SIZE));
+        std::vector<char> matched(count, 0);
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < count; t++)
+        {
+            uint64_t share = maxAttempts / count + (t < maxAttempts % count ? 1 : 0);
+            workers.push_back(std::thread([&, t, share]() {
+                bool match = false;
+                mineSalts(inputs[t].data(), nibblePrefix, t, count, share, found, attempts, match);
+                matched[t] = match;
+            }));
+        }
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+        for (size_t t = 0; t < count && !result.found; t++)
+        {
+            if (matched[t])
+            {
+                memcpy(input, inputs[t].data(), CREATE2_INPUT_SIZE);
+                result.found = true;
+            }
+        }
+        result.attempts = attempts;
+    #else
+        bool found = false;
+        uint64_t attempts = 0;
+        mineSalts(input, nibblePrefix, 0, 1, maxAttempts, found, attempts, result.found);
+        result.attempts = attempts;
+    #endif
+
+        result.elapsedMilliseconds = (uint32_t)(millis() - start);
+        if (result.found)
+        {
+            result.salt = std::vector<uint8_t>(input + CREATE2_SALT_OFFSET, input + CREATE2_SALT_OFFSET + CREATE2_SALT_SIZE);
+            uint8_t hash[KECCAK_256_LENGTH];
+            keccak_256(input, CREATE2_INPUT_SIZE, hash);
+            result.address = addressFromHash(hash);
+        }
+        return result;
+    }
+}
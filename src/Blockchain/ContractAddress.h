@@ -0,0 +1,82 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2023 Tord Wessman
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef __CONTRACT_ADDRESS_H__
+#define __CONTRACT_ADDRESS_H__
+
+#include <vector>
+#include <stdint.h>
+
+#include "../Shared/Common.h"
+#include "Address.h"
+
+namespace blockchain
+{
+    /// Size of a `CREATE2` salt.
+    #define CREATE2_SALT_SIZE 32
+
+    /// @brief Returns the address of a contract deployed (using `CREATE`) by `sender` with nonce `nonce`: the last 20 bytes of `keccak256(rlp([sender, nonce]))`.
+    Address CreateAddress(const Address &sender, uint64_t nonce);
+
+    /// @brief Returns the address of a contract deployed using `CREATE2`: the last 20 bytes of `keccak256(0xff || sender || salt || keccak256(initCode))`.
+    /// @param sender The deploying contract (e.g. a factory).
+    /// @param salt 32 bytes.
+    /// @param initCode The creation code, including constructor arguments.
+    Address Create2Address(const Address &sender, const std::vector<uint8_t> &salt, const std::vector<uint8_t> &initCode);
+
+    /// @brief Returns the `CREATE2` address using the hash of the creation code, e.g. when deploying many contracts from the same code.
+    /// @param sender The deploying contract (e.g. a factory).
+    /// @param salt 32 bytes.
+    /// @param initCodeHash `keccak256(initCode)`.
+    Address Create2AddressFromHash(const Address &sender, const std::vector<uint8_t> &salt, const std::vector<uint8_t> &initCodeHash);
+
+    /// @brief The result of `MineCreate2Salt`.
+    struct Create2Salt
+    {
+        /// @brief `true` if a matching salt was found.
+        bool found;
+        std::vector<uint8_t> salt;
+        Address address;
+        /// @brief The number of salts tried.
+        uint64_t attempts;
+        uint32_t elapsedMilliseconds;
+
+        /// @brief The number of salts tried per second.
+        double Throughput() const { return elapsedMilliseconds > 0 ? attempts * 1000.0 / elapsedMilliseconds : 0; }
+    };
+
+    /// @brief Searches for a salt whose `CREATE2` address starts with `prefix`. The last 8 bytes of `baseSalt` are replaced by a counter,
+    /// which is partitioned between `threads` threads (on platforms supporting threads).
+    /// @param sender The deploying contract (e.g. a factory).
+    /// @param initCodeHash `keccak256(initCode)`.
+    /// @param prefix The hex digits the address should start with (case-insensitive, with or without "0x").
+    /// @param maxAttempts The number of salts to try before giving up.
+    /// @param threads
+    /// @param baseSalt 32 bytes, e.g. starting with the address of the only account allowed to deploy using the salt. Defaults to zeros.
+    /// @return
+    Create2Salt MineCreate2Salt(const Address &sender, const std::vector<uint8_t> &initCodeHash, const char *prefix, uint64_t maxAttempts,
+                                uint8_t threads = 1, const std::vector<uint8_t> &baseSalt = std::vector<uint8_t>());
+}
+#endif
@@ -0,0 +1,387 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2023 Tord Wessman
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef __CONTRACT_FUNCTION_H__
+#define __CONTRACT_FUNCTION_H__
+
+#include <vector>
+#include <stdint.h>
+
+#include "../Shared/Common.h"
+#include "../Shared/BigNumber.h"
+#include "Address.h"
+#include "Contract.h"
+#include "ABIDecoder.h"
+#include "Keccak256Constant.h"
+
+// Compile-time signatures and selectors rely on C++14 `constexpr`.
+#if __cplusplus >= 201402L
+
+/// Declares a type holding the name of a contract function, for use with `ContractFunction`.
+/// Example: `CONTRACT_FUNCTION_NAME(Transfer, "transfer");`
+#define CONTRACT_FUNCTION_NAME(identifier, name) \
+    struct identifier { static constexpr const char *Value() { return name; } }
+
+namespace blockchain
+{
+    #define FUNCTION_SIGNATURE_CAPACITY 256
+
+    /// @brief Reports an invalid `FunctionSignature`. Not being `constexpr`, any call during constant evaluation results in a compile error.
+    inline void functionSignatureError(const char *message) { THROW(message); }
+
+    /// @brief A canonical function signature (e.g. `transfer(address,uint256)`) built at compile time.
+    struct FunctionSignature
+    {
+        constexpr FunctionSignature() : data{}, length(0) {}
+
+        constexpr void Append(const char *string)
+        {
+            for (; *string != '\0'; string++)
+            {
+                if (length + 1 >= FUNCTION_SIGNATURE_CAPACITY) { functionSignatureError("Function signature is too long."); }
+                data[length++] = *string;
+            }
+        }
+
+        constexpr void AppendNumber(uint32_t number)
+        {
+            char digits[11] = {};
+            size_t count = 0;
+            do
+            {
+                digits[count++] = '0' + number % 10;
+                number /= 10;
+            } while (number > 0);
+
+            char reversed[11] = {};
+            for (size_t i = 0; i < count; i++) { reversed[i] = digits[count - i - 1]; }
+            Append(reversed);
+        }
+
+        /// @brief Appends `,` unless this is the first parameter of the list.
+        constexpr void AppendSeparator()
+        {
+            if (length > 0 && data[length - 1] != '(') { Append(","); }
+        }
+
+        /// @brief Returns the first `KECCAK256_SIGNATURE_SIZE` bytes of the Keccak-256 hash of the signature.
+        constexpr Keccak256Constant Hash() const { return Keccak256Constant::Hash(data, length); }
+
+        char data[FUNCTION_SIGNATURE_CAPACITY];
+        size_t length;
+    };
+
+    /// @brief ABI type tags for `ContractFunction`. Each tag defines the C++ types used for arguments and results,
+    /// its canonical name and how it is encoded and decoded.
+    namespace abi
+    {
+        /// @brief Writes a length or offset word.
+        inline void writeSize(size_t value, uint8_t *word)
+        {
+            for (size_t i = 0; i < sizeof(size_t) && i < 32; i++) { word[31 - i] = (uint8_t)(value >> (i * 8)); }
+        }
+
+        inline size_t paddedLength(size_t length) { return (length + 31) / 32 * 32; }
+
+        template <uint16_t Bits>
+        struct UInt
+        {
+            static_assert(Bits > 0 && Bits <= 256 && Bits % 8 == 0, "Invalid uint size.");
+            typedef BigNumber ArgumentType;
+            typedef BigNumber ResultType;
+            static constexpr bool IsDynamic() { return false; }
+            static constexpr void AppendName(FunctionSignature &signature) { signature.Append("uint"); signature.AppendNumber(Bits); }
+            static size_t TailSize(const ArgumentType &) { return 0; }
+            static void Write(const ArgumentType &value, uint8_t *head, uint8_t *)
+            {
+                if (!value.FitsInBits(Bits, false)) { THROW("Value out of range for unsigned integer type."); }
+                value.WriteBigEndian(*reinterpret_cast<uint8_t(*)[32]>(head));
+            }
+            static ResultType Read(const ABIValue &value) { return value.ToBigNumber(); }
+        };
+
+        template <uint16_t Bits>
+        struct Int
+        {
+            static_assert(Bits > 0 && Bits <= 256 && Bits % 8 == 0, "Invalid int size.");
+            typedef BigNumber ArgumentType;
+            typedef BigNumber ResultType;
+            static constexpr bool IsDynamic() { return false; }
+            static constexpr void AppendName(FunctionSignature &signature) { signature.Append("int"); signature.AppendNumber(Bits); }
+            static size_t TailSize(const ArgumentType &) { return 0; }
+            static void Write(const ArgumentType &value, uint8_t *head, uint8_t *)
+            {
+                if (!value.FitsInBits(Bits, true)) { THROW("Value out of range for signed integer type."); }
+                value.WriteTwosComplement(*reinterpret_cast<uint8_t(*)[32]>(head));
+            }
+            static ResultType Read(const ABIValue &value) { return value.ToBigNumber(); }
+        };
+
+        typedef UInt<256> UInt256;
+        typedef Int<256> Int256;
+
+        struct Address
+        {
+            typedef blockchain::Address ArgumentType;
+            typedef blockchain::Address ResultType;
+            static constexpr bool IsDynamic() { return false; }
+            static constexpr void AppendName(FunctionSignature &signature) { signature.Append("address"); }
+            static size_t TailSize(const ArgumentType &) { return 0; }
+            static void Write(const ArgumentType &value, uint8_t *head, uint8_t *)
+            {
+                const char *hex = value.AsString() + 2;
+                for (size_t i = 0; i < (ETH_ADDRESS_LENGTH - 2) / 2; i++)
+                {
+                    head[12 + i] = (Nibble(hex[i * 2]) << 4) | Nibble(hex[i * 2 + 1]);
+                }
+            }
+            static ResultType Read(const ABIValue &value) { return value.ToAddress(); }
+
+        private:
+            static uint8_t Nibble(char c)
+            {
+                if (c >= '0' && c <= '9') { return c - '0'; }
+                if (c >= 'a' && c <= 'f') { return c - 'a' + 10; }
+                if (c >= 'A' && c <= 'F') { return c - 'A' + 10; }
+                THROW("Invalid character in address.");
+                return 0;
+            }
+        };
+
+        struct Bool
+        {
+            typedef bool ArgumentType;
+            typedef bool ResultType;
+            static constexpr bool IsDynamic() { return false; }
+            static constexpr void AppendName(FunctionSignature &signature) { signature.Append("bool"); }
+            static size_t TailSize(const ArgumentType &) { return 0; }
+            static void Write(const ArgumentType &value, uint8_t *head, uint8_t *) { head[31] = value ? 1 : 0; }
+            static ResultType Read(const ABIValue &value) { return value.ToBool(); }
+        };
+
+        template <uint8_t Length>
+        struct FixedBytes
+        {
+            static_assert(Length > 0 && Length <= 32, "Invalid bytesN size.");
+            typedef std::vector<uint8_t> ArgumentType;
+            typedef std::vector<uint8_t> ResultType;
+            static constexpr bool IsDynamic() { return false; }
+            static constexpr void AppendName(FunctionSignature &signature) { signature.Append("bytes"); signature.AppendNumber(Length); }
+            static size_t TailSize(const ArgumentType &) { return 0; }
+            static void Write(const ArgumentType &value, uint8_t *head, uint8_t *)
+            {
+                if (value.size() != Length) { THROW("Invalid length for bytesN type."); }
+                memcpy(head, value.data(), Length);
+            }
+            static ResultType Read(const ABIValue &value) { return value.Bytes().ToVector(); }
+        };
+
+        typedef FixedBytes<32> Bytes32;
+
+        struct Bytes
+        {
+            typedef std::vector<uint8_t> ArgumentType;
+            typedef std::vector<uint8_t> ResultType;
+            static constexpr bool IsDynamic() { return true; }
+            static constexpr void AppendName(FunctionSignature &signature) { signature.Append("bytes"); }
+            static size_t TailSize(const ArgumentType &value) { return 32 + paddedLength(value.size()); }
+            static void Write(const ArgumentType &value, uint8_t *, uint8_t *tail)
+            {
+                writeSize(value.size(), tail);
+                memcpy(tail + 32, value.data(), value.size());
+            }
+            static ResultType Read(const ABIValue &value) { return value.Bytes().ToVector(); }
+        };
+
+        /// @brief Results are returned as allocated strings that need to be deallocated manually.
+        struct String
+        {
+            typedef const char *ArgumentType;
+            typedef char *ResultType;
+            static constexpr bool IsDynamic() { return true; }
+            static constexpr void AppendName(FunctionSignature &signature) { signature.Append("string"); }
+            static size_t TailSize(const ArgumentType &value) { return 32 + paddedLength(strlen(value)); }
+            static void Write(const ArgumentType &value, uint8_t *, uint8_t *tail)
+            {
+                size_t length = strlen(value);
+                writeSize(length, tail);
+                memcpy(tail + 32, value, length);
+            }
+            static ResultType Read(const ABIValue &value) { return value.GenerateString(); }
+        };
+
+        /// @brief A dynamic array (`T[]`).
+        template <typename T>
+        struct Array
+        {
+            typedef std::vector<typename T::ArgumentType> ArgumentType;
+            typedef std::vector<typename T::ResultType> ResultType;
+            static constexpr bool IsDynamic() { return true; }
+            static constexpr void AppendName(FunctionSignature &signature) { T::AppendName(signature); signature.Append("[]"); }
+            static size_t TailSize(const ArgumentType &value)
+            {
+                size_t size = 32 + 32 * value.size();
+                for (const typename T::ArgumentType &element : value) { size += T::TailSize(element); }
+                return size;
+            }
+            static void Write(const ArgumentType &value, uint8_t *, uint8_t *tail)
+            {
+                writeSize(value.size(), tail);
+                uint8_t *region = tail + 32;
+                size_t tailPosition = 32 * value.size();
+                for (size_t i = 0; i < value.size(); i++)
+                {
+                    if (T::IsDynamic()) { writeSize(tailPosition, region + 32 * i); }
+                    T::Write(value[i], region + 32 * i, region + tailPosition);
+                    tailPosition += T::TailSize(value[i]);
+                }
+            }
+            static ResultType Read(const ABIValue &value)
+            {
+                ResultType result;
+                result.reserve(value.Count());
+                for (size_t i = 0; i < value.Count(); i++) { result.push_back(T::Read(value[i])); }
+                return result;
+            }
+        };
+    }
+
+    template <typename Name, typename Function>
+    class ContractFunction;
+
+    /// @brief A contract function without a (decoded) return value. Example:
+    ///
+    ///     CONTRACT_FUNCTION_NAME(Approve, "approve");
+    ///     typedef ContractFunction<Approve, void(abi::Address, abi::UInt256)> ApproveFunction;
+    ///     ContractCall call = ApproveFunction::Call(spender, amount);
+    ///
+    /// The canonical signature and the selector are computed at compile time and arguments are encoded without
+    /// any intermediate `EncodableItem`s.
+    template <typename Name, typename... Args>
+    class ContractFunction<Name, void(Args...)>
+    {
+    public:
+        /// @brief Returns the canonical signature (e.g. `approve(address,uint256)`).
+        static constexpr FunctionSignature Signature()
+        {
+            FunctionSignature signature;
+            signature.Append(Name::Value());
+            signature.Append("(");
+            int expand[] = {0, (signature.AppendSeparator(), Args::AppendName(signature), 0)...};
+            (void)expand;
+            signature.Append(")");
+            return signature;
+        }
+
+        /// @brief Returns the Keccak-256 hash of the signature. The first `KECCAK256_SIGNATURE_SIZE` bytes are the selector.
+        static constexpr Keccak256Constant SignatureHash() { return Signature().Hash(); }
+
+        /// @brief Returns the call data (selector followed by the encoded arguments).
+        static std::vector<uint8_t> Encode(const typename Args::ArgumentType &...arguments)
+        {
+            constexpr Keccak256Constant hash = SignatureHash();
+            const size_t headSize = 32 * sizeof...(Args);
+            size_t tailSizes[] = {0, Args::TailSize(arguments)...};
+            size_t size = KECCAK256_SIGNATURE_SIZE + headSize;
+            for (size_t tailSize : tailSizes) { size += tailSize; }
+
+            std::vector<uint8_t> callData(size);
+            memcpy(callData.data(), hash.bytes, KECCAK256_SIGNATURE_SIZE);
+
+            uint8_t *region = callData.data() + KECCAK256_SIGNATURE_SIZE;
+            size_t headPosition = 0;
+            size_t tailPosition = headSize;
+            int expand[] = {0, (WriteArgument<Args>(arguments, region, headPosition, tailPosition), 0)...};
+            (void)expand;
+            return callData;
+        }
+
+        /// @brief Returns a `ContractCall` to pass to `Chain::ViewCall` or `Chain::Send`.
+        static ContractCall Call(const typename Args::ArgumentType &...arguments)
+        {
+            return ContractCall(Encode(arguments...));
+        }
+
+    private:
+        template <typename T>
+        static void WriteArgument(const typename T::ArgumentType &argument, uint8_t *region, size_t &headPosition, size_t &tailPosition)
+        {
+            if (T::IsDynamic()) { abi::writeSize(tailPosition, region + headPosition); }
+            T::Write(argument, region + headPosition, region + tailPosition);
+            headPosition += 32;
+            tailPosition += T::TailSize(argument);
+        }
+    };
+
+    /// @brief A contract function with a typed return value. Example:
+    ///
+    ///     CONTRACT_FUNCTION_NAME(BalanceOf, "balanceOf");
+    ///     typedef ContractFunction<BalanceOf, abi::UInt256(abi::Address)> BalanceOfFunction;
+    ///     ContractCall call = BalanceOfFunction::Call(owner);
+    ///     Result<BigNumber> balance = BalanceOfFunction::DecodeResult(response.Result());
+    ///
+    template <typename Name, typename Return, typename... Args>
+    class ContractFunction<Name, Return(Args...)> : public ContractFunction<Name, void(Args...)>
+    {
+    public:
+        /// @brief Decodes the (hex-encoded) result of a call to this function.
+        /// @param result
+        /// @return The decoded value or `ABI_DECODE_ERROR` if `result` is not a valid encoding of the return type.
+        static Result<typename Return::ResultType> DecodeResult(const char *result)
+        {
+            std::vector<uint8_t> bytes = result | byte_array::hex_string_to_bytes;
+            return DecodeResult(bytes.data(), bytes.size());
+        }
+
+        /// @brief Decodes the raw result of a call to this function.
+        static Result<typename Return::ResultType> DecodeResult(const uint8_t *data, size_t length)
+        {
+            Result<ABIValue> value = ABIDecoder().Decode(&ReturnType(), data, length);
+            if (!value.HasValue())
+            {
+                return Result<typename Return::ResultType>::Err(value);
+            }
+            return Return::Read(value.Value()[0]);
+        }
+
+    private:
+        /// @brief The return type, parsed once.
+        static const ABIType &ReturnType()
+        {
+            static const ABIType type = ParseReturnType();
+            return type;
+        }
+
+        static ABIType ParseReturnType()
+        {
+            FunctionSignature name;
+            Return::AppendName(name);
+            return ABIType::Parse(name.data).Value();
+        }
+    };
+}
+
+#endif
+#endif
@@ -0,0 +1,275 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2023 Tord Wessman
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <algorithm>
+
+#include "EIP712.h"
+#include "ABIEncoder.h"
+#include "Signer.h"
+
+namespace blockchain
+{
+    #define EIP712_SLOT_LENGTH 32
+
+    /// @brief Returns the length of `type` without array suffixes (e.g. 6 for "Person[]").
+    static size_t baseTypeLength(const char *type)
+    {
+        const char *bracket = strchr(type, '[');
+        return bracket != nullptr ? bracket - type : strlen(type);
+    }
+
+    static bool isAtomicType(const char *type, size_t length)
+    {
+        const char *prefixes[] = {"uint", "int", "bytes", "address", "bool", "string"};
+        for (const char *prefix : prefixes)
+        {
+            size_t prefixLength = strlen(prefix);
+            if (length >= prefixLength && strncmp(type, prefix, prefixLength) == 0)
+            {
+                // Any remaining characters must be the size (e.g. "uint256" or "bytes32").
+                size_t i = prefixLength;
+                while (i < length && type[i] >= '0' && type[i] <= '9') { i++; }
+                if (i == length) { return true; }
+            }
+        }
+        return false;
+    }
+
+    static void append(std::vector<uint8_t> &string, const char *value)
+    {
+        string.insert(string.end(), value, value + strlen(value));
+    }
+
+    EIP712Hasher::EIP712Hasher(const char *name, const char *version, uint32_t chainId, const Address verifyingContract) :
+        EIP712Hasher({{"name", "string"}, {"version", "string"}, {"chainId", "uint256"}, {"verifyingContract", "address"}},
+                     {EncodableItem(name), EncodableItem(version), EncodableItem(chainId), EncodableItem(verifyingContract)}) {}
+
+    EIP712Hasher::EIP712Hasher(const std::vector<EIP712Field> domainFields, const std::vector<EncodableItem> domainValues)
+    {
+        AddType("EIP712Domain", domainFields);
+        domainSeparator = HashStruct("EIP712Domain", domainValues);
+    }
+
+    EIP712Hasher &EIP712Hasher::AddType(const char *name, const std::vector<EIP712Field> fields)
+    {
+        if (FindType(name, strlen(name)) != nullptr)
+        {
+            THROW("EIP-712 type is already registered.");
+        }
+
+        StructType type;
+        type.name = name;
+        type.fields = fields;
+        types.push_back(type);
+
+        // The new type may complete the dependencies of previously registered types.
+        for (StructType &registered : types)
+        {
+            UpdateTypeHash(registered);
+        }
+        return *this;
+    }
+
+    const std::vector<uint8_t> &EIP712Hasher::TypeHash(const char *type) const
+    {
+        const StructType *structType = FindType(type, strlen(type));
+        if (structType == nullptr || structType->typeHash.empty())
+        {
+            THROW("Unknown EIP-712 type or missing dependencies.");
+        }
+        return structType->typeHash;
+    }
+
+    const EIP712Hasher::StructType *EIP712Hasher::FindType(const char *name, size_t length) const
+    {
+        for (const StructType &type : types)
+        {
+            if (strncmp(type.name, name, length) == 0 && type.name[length] == '\0')
+            {
+                return &type;
+            }
+        }
+        return nullptr;
+    }
+
+    void EIP712Hasher::CollectDependencies(const StructType *type, std::vector<const StructType *> &dependencies) const
+    {
+        if (std::find(dependencies.begin(), dependencies.end(), type) != dependencies.end())
+        {
+            return;
+        }
+        dependencies.push_back(type);
+
+        for (const EIP712Field &field : type->fields)
+        {
+            const StructType *dependency = FindType(field.type, baseTypeLength(field.type));
+            if (dependency != nullptr)
+            {
+                CollectDependencies(dependency, dependencies);
+            }
+        }
+    }
+
+    bool EIP712Hasher::UpdateTypeHash(StructType &type)
+    {
+        std::vector<const StructType *> dependencies;
+        CollectDependencies(&type, dependencies);
+
+        for (const StructType *dependency : dependencies)
+        {
+            for (const EIP712Field &field : dependency->fields)
+            {
+                size_t length = baseTypeLength(field.type);
+                if (!isAtomicType(field.type, length) && FindType(field.type, length) == nullptr)
+                {
+                    type.typeHash.clear();
+                    return false;
+                }
+            }
+        }
+
+        // encodeType: the primary type followed by its dependencies sorted by name.
+        std::sort(dependencies.begin() + 1, dependencies.end(), [](const StructType *a, const StructType *b) {
+            return strcmp(a->name, b->name) < 0;
+        });
+
+        std::vector<uint8_t> encodedType;
+        for (const StructType *dependency : dependencies)
+        {
+            append(encodedType, dependency->name);
+            encodedType.push_back('(');
+            for (size_t i = 0; i < dependency->fields.size(); i++)
+            {
+                if (i > 0) { encodedType.push_back(','); }
+                append(encodedType, dependency->fields[i].type);
+                encodedType.push_back(' ');
+                append(encodedType, dependency->fields[i].name);
+            }
+            encodedType.push_back(')');
+        }
+
+        type.typeHash = Keccak256(&encodedType);
+        return true;
+    }
+
+    void EIP712Hasher::EncodeValue(const char *type, const EncodableItem &value, uint8_t *slot) const
+    {
+        size_t length = baseTypeLength(type);
+
+        if (type[length] == '[')
+        {
+            // Arrays are encoded as the hash of their concatenated, encoded elements.
+            const char *lastBracket = strrchr(type, '[');
+            std::vector<char> elementType(type, lastBracket);
+            elementType.push_back('\0');
+
+            const std::vector<EncodableItem> &elements = value.Children();
+            std::vector<uint8_t> encoded(elements.size() * EIP712_SLOT_LENGTH);
+            for (size_t i = 0; i < elements.size(); i++)
+            {
+                EncodeValue(elementType.data(), elements[i], encoded.data() + i * EIP712_SLOT_LENGTH);
+            }
+            std::vector<uint8_t> hash = Keccak256(&encoded);
+            memcpy(slot, hash.data(), EIP712_SLOT_LENGTH);
+            return;
+        }
+
+        const StructType *structType = FindType(type, length);
+        if (structType != nullptr)
+        {
+            std::vector<uint8_t> hash = HashStruct(structType, value.Children());
+            memcpy(slot, hash.data(), EIP712_SLOT_LENGTH);
+            return;
+        }
+
+        if (strcmp(type, "string") == 0 || strcmp(type, "bytes") == 0)
+        {
+            const ByteView bytes = value.Bytes();
+            std::vector<uint8_t> hash = Keccak256(bytes.data(), bytes.size());
+            memcpy(slot, hash.data(), EIP712_SLOT_LENGTH);
+            return;
+        }
+
+        if (strncmp(type, "bytes", 5) == 0)
+        {
+            // bytesN is left-aligned.
+            const ByteView bytes = value.Bytes();
+            if (bytes.size() > EIP712_SLOT_LENGTH)
+            {
+                THROW("Value exceeds the size of its bytesN type.");
+            }
+            memset(slot, 0, EIP712_SLOT_LENGTH);
+            memcpy(slot, bytes.data(), bytes.size());
+            return;
+        }
+
+        if (ABIEncoder::IsDynamic(&value))
+        {
+            THROW("Value does not match its EIP-712 type.");
+        }
+        ABIEncoder().Write(&value, slot);
+    }
+
+    std::vector<uint8_t> EIP712Hasher::HashStruct(const char *type, const std::vector<EncodableItem> &values) const
+    {
+        const StructType *structType = FindType(type, strlen(type));
+        if (structType == nullptr)
+        {
+            THROW("Unknown EIP-712 type.");
+        }
+        return HashStruct(structType, values);
+    }
+
+    std::vector<uint8_t> EIP712Hasher::HashStruct(const StructType *type, const std::vector<EncodableItem> &values) const
+    {
+        if (type->typeHash.empty())
+        {
+            THROW("EIP-712 type has missing dependencies.");
+        }
+        if (values.size() != type->fields.size())
+        {
+            THROW("Invalid number of values for EIP-712 type.");
+        }
+
+        std::vector<uint8_t> encoded((1 + values.size()) * EIP712_SLOT_LENGTH);
+        memcpy(encoded.data(), type->typeHash.data(), EIP712_SLOT_LENGTH);
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            EncodeValue(type->fields[i].type, values[i], encoded.data() + (1 + i) * EIP712_SLOT_LENGTH);
+        }
+        return Keccak256(&encoded);
+    }
+
+    std::vector<uint8_t> EIP712Hasher::Hash(const char *primaryType, const std::vector<EncodableItem> &message) const
+    {
+        std::vector<uint8_t> structHash = HashStruct(primaryType, message);
+        std::vector<uint8_t> encoded(2 + 2 * EIP712_SLOT_LENGTH);
+        encoded[0] = 0x19;
+        encoded[1] = 0x01;
+        memcpy(encoded.data() + 2, domainSeparator.data(), EIP712_SLOT_LENGTH);
+        memcpy(encoded.data() + 2 + EIP712_SLOT_LENGTH, structHash.data(), EIP712_SLOT_LENGTH);
+        return Keccak256(&encoded);
+    }
+}
@@ -0,0 +1,97 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2023 Tord Wessman
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef __EIP712_H__
+#define __EIP712_H__
+
+#include <vector>
+#include <stdint.h>
+
+#include "../Shared/Common.h"
+#include "Encodable.h"
+#include "Address.h"
+
+namespace blockchain
+{
+    /// @brief A member of an EIP-712 struct type, e.g. `{"owner", "address"}`. The strings are not copied.
+    struct EIP712Field
+    {
+        const char *name;
+        const char *type;
+    };
+
+    /// @brief Hashes EIP-712 typed structured data (e.g. ERC-2612 permits or off-chain orders).
+    /// Struct values are passed as `EncodableItem` vectors with one item per field, in declaration order. Nested structs and 
+    /// arrays are passed as `ItemArray`s. The type hash of every registered type and the domain separator are computed once.
+    /// Hashing is read-only and may be done concurrently once all types are registered.
+    class EIP712Hasher
+    {
+    public:
+        /// @brief Creates a hasher for the common `EIP712Domain(string name,string version,uint256 chainId,address verifyingContract)` domain.
+        EIP712Hasher(const char *name, const char *version, uint32_t chainId, const Address verifyingContract);
+
+        /// @brief Creates a hasher for a custom domain (any subset of `name`, `version`, `chainId`, `verifyingContract` and `salt`).
+        /// @param domainFields The fields of `EIP712Domain`.
+        /// @param domainValues The values of `domainFields`.
+        EIP712Hasher(const std::vector<EIP712Field> domainFields, const std::vector<EncodableItem> domainValues);
+
+        /// @brief Registers a struct type. The strings are not copied and must outlive the hasher.
+        /// @param name The type name, e.g. "Permit".
+        /// @param fields
+        /// @return This hasher.
+        EIP712Hasher &AddType(const char *name, const std::vector<EIP712Field> fields);
+
+        /// @brief Returns the cached `keccak256(encodeType(type))`.
+        const std::vector<uint8_t> &TypeHash(const char *type) const;
+
+        /// @brief Returns the cached domain separator.
+        const std::vector<uint8_t> &DomainSeparator() const { return domainSeparator; }
+
+        /// @brief Returns `hashStruct(value)` for a value of the struct type `type`.
+        std::vector<uint8_t> HashStruct(const char *type, const std::vector<EncodableItem> &values) const;
+
+        /// @brief Returns the digest to sign: `keccak256(0x19 0x01 || domainSeparator || hashStruct(message))`.
+        std::vector<uint8_t> Hash(const char *primaryType, const std::vector<EncodableItem> &message) const;
+
+    private:
+        struct StructType
+        {
+            const char *name;
+            std::vector<EIP712Field> fields;
+            std::vector<uint8_t> typeHash;
+        };
+
+        const StructType *FindType(const char *name, size_t length) const;
+        void CollectDependencies(const StructType *type, std::vector<const StructType *> &dependencies) const;
+        bool UpdateTypeHash(StructType &type);
+        void EncodeValue(const char *type, const EncodableItem &value, uint8_t *slot) const;
+        std::vector<uint8_t> HashStruct(const StructType *type, const std::vector<EncodableItem> &values) const;
+
+        std::vector<StructType> types;
+        std::vector<uint8_t> domainSeparator;
+    };
+}
+
+#endif
@@ -27,6 +27,8 @@
 
 #include <vector>
 #include <stdint.h>
+#include <cstdlib>
+#include <utility>
 
 #include "../Shared/Common.h"
 #include "../Shared/BigNumber.h"
@@ -43,68 +45,229 @@ namespace blockchain
         String,
         ItemArray,
         UnsignedInt,
-        Bool
+        SignedInt,
+        Bool,
+        FixedBytes,
+        FixedArray,
+        Tuple
     };
 
     /// Macro for `EncodableItem` constructors. (e.g. `ENC(aValue, "uint64")`).
     #define ENC EncodableItem
 
+    /// @brief Values up to this size (e.g. integers, addresses and `bytesN`) are stored inline in the `EncodableItem`.
+    #define ENCODABLE_INLINE_CAPACITY 32
+
     /// @brief Represents an object prepared for encoding.
     /// The encoded data could either be an array of `EncodableItem`'s or a concrete value-type.
+    /// Small values are stored inline, larger values are moved into a heap buffer and `Borrowed` items only reference their data.
     class EncodableItem
     {
     public:
 
-        /// @brief Encode as a binary array.
-        EncodableItem(const std::vector<uint8_t> value, const char* handle = "bytes") : type(EncodableItemType::Binary), bytes(value), handle(handle) {}
+        /// @brief Encode as a binary array. A "bytesN" `handle` (e.g. "bytes32") encodes `value` as a static, left-aligned `bytesN`.
+        EncodableItem(std::vector<uint8_t> value, const char* handle = "bytes") : type(BinaryType(handle, value.size())), handle(handle) { Store(std::move(value)); }
 
         /// @brief Encode as address
-        EncodableItem(const Address *value) : type(EncodableItemType::Address), bytes(value->AsString() | byte_array::hex_string_to_bytes), handle("address") {}
+        EncodableItem(const Address *value) : type(EncodableItemType::Address), handle("address") { Store(value->AsString() | byte_array::hex_string_to_bytes); }
         
         /// @brief Encode as address
-        EncodableItem(const Address value) : type(EncodableItemType::Address), bytes(value.AsString() | byte_array::hex_string_to_bytes), handle("address") {}
+        EncodableItem(const Address value) : type(EncodableItemType::Address), handle("address") { Store(value.AsString() | byte_array::hex_string_to_bytes); }
 
         /// @brief Encode as a 32-bit unsigned integer. `handle` defaults to "uint256".
-        EncodableItem(uint32_t value, const char *handle = "uint256") : type(EncodableItemType::UnsignedInt), bytes(value | byte_array::uint_to_bytes), handle(handle) {}
+        EncodableItem(uint32_t value, const char *handle = "uint256") : type(EncodableItemType::UnsignedInt), handle(handle) { Store(value | byte_array::uint_to_bytes); }
 
         /// @brief Encode as a 16-bit unsigned integer. `handle` defaults to "uint256".
-        EncodableItem(uint16_t value, const char *handle = "uint256") : type(EncodableItemType::UnsignedInt), bytes((uint32_t)value | byte_array::uint_to_bytes), handle(handle) {}
+        EncodableItem(uint16_t value, const char *handle = "uint256") : type(EncodableItemType::UnsignedInt), handle(handle) { Store((uint32_t)value | byte_array::uint_to_bytes); }
 
         /// @brief Encode as a 8-bit unsigned integer. `handle` defaults to "uint256".
-        EncodableItem(uint8_t value, const char *handle = "uint256") : type(EncodableItemType::UnsignedInt), bytes((uint32_t)value | byte_array::uint_to_bytes), handle(handle) {}
+        EncodableItem(uint8_t value, const char *handle = "uint256") : type(EncodableItemType::UnsignedInt), handle(handle) { Store((uint32_t)value | byte_array::uint_to_bytes); }
+
+        /// @brief Encode a 32-bit signed integer. `handle` defaults to "int256". An unsigned handle (e.g. "uint32") accepts 
+        /// non-negative values, so that plain literals such as `ENC(5, "uint256")` work.
+        EncodableItem(int32_t value, const char *handle = "int256") : 
+            EncodableItem(value < 0 ? -BigNumber((uint32_t)(-(int64_t)value)) : BigNumber((uint32_t)value), handle) {}
 
-        /// @brief Encode any `BigNumber`.
-        EncodableItem(const BigNumber *value, const char *handle = "uint256") : type(EncodableItemType::UnsignedInt), bytes(value->Bytes() | byte_array::truncate), handle(handle) {}
+        /// @brief Encode any `BigNumber`. Signed handles (e.g. "int128") are encoded as two's complement.
+        EncodableItem(const BigNumber *value, const char *handle = "uint256") : EncodableItem(*value, handle) {}
 
-        /// @brief Encode any `BigNumber`.
-        EncodableItem(const BigNumber &value, const char *handle = "uint256") : type(EncodableItemType::UnsignedInt), bytes(value.Bytes() | byte_array::truncate), handle(handle) {}
+        /// @brief Encode any `BigNumber`. Signed handles (e.g. "int128") are encoded as two's complement.
+        EncodableItem(const BigNumber &value, const char *handle = "uint256") : 
+            type(IsSignedHandle(handle) ? EncodableItemType::SignedInt : EncodableItemType::UnsignedInt), 
+            handle(handle) 
+        {
+            if (type == EncodableItemType::SignedInt) { Store(SignedBytes(value, handle)); }
+            else { StoreUnsigned(value); }
+        }
 
         /// @brief Encode a string.
-        EncodableItem(const char *value) : type(EncodableItemType::String), bytes(value | byte_array::string_to_bytes), handle("string") {}
+        EncodableItem(const char *value) : type(EncodableItemType::String), handle("string") { Store((const uint8_t *)value, strlen(value)); }
 
         /// @brief Encode as a bool.
-        EncodableItem(const bool value) : type(EncodableItemType::Bool), bytes(std::vector<uint8_t> {(uint8_t)value}), handle("uint8") {}
+        EncodableItem(const bool value) : type(EncodableItemType::Bool), handle("uint8") { uint8_t byte = (uint8_t)value; Store(&byte, 1); }
+
+        /// @brief Encode a list of sub-items. For ABI-encoding, `handle` selects the type: "T[]" for a dynamic array,
+        /// "T[k]" for a fixed-size array (which must contain `k` items) and "(T1,T2,...)" for a tuple (struct).
+        EncodableItem(std::vector<EncodableItem> items, const char* handle = "") : type(ListType(handle, items.size())), children(std::move(items)), handle(handle) { Store(nullptr, 0); }
+
+        /// @brief Encode `value` as a binary array without copying it. The referenced data must outlive the item and any copies of it.
+        static EncodableItem Borrowed(ByteView value, const char *handle = "bytes")
+        {
+            EncodableItem item(EncodableItemType::Binary, handle);
+            item.data = value.data();
+            item.length = value.size();
+            return item;
+        }
+
+        EncodableItem(const EncodableItem &other) : type(other.type), heapBytes(other.heapBytes), children(other.children), handle(other.handle), length(other.length)
+        {
+            Rebase(other);
+        }
+
+        EncodableItem(EncodableItem &&other) : type(other.type), heapBytes(std::move(other.heapBytes)), children(std::move(other.children)), handle(other.handle), length(other.length)
+        {
+            // A moved vector keeps its buffer, so only inline storage needs to be re-pointed.
+            if (other.data == other.inlineBytes) { memcpy(inlineBytes, other.inlineBytes, length); data = inlineBytes; }
+            else { data = other.data; }
+        }
+
+        EncodableItem &operator=(const EncodableItem &other)
+        {
+            if (this != &other)
+            {
+                type = other.type;
+                heapBytes = other.heapBytes;
+                children = other.children;
+                handle = other.handle;
+                length = other.length;
+                Rebase(other);
+            }
+            return *this;
+        }
 
-        /// @brief Encode a list of sub-items.
-        EncodableItem(const std::vector<EncodableItem> items, const char* handle = "") : type(EncodableItemType::ItemArray), children(items), handle(handle) {}
-        
         /// @brief Return the original type of the encoded content. 
         EncodableItemType Type() const { return type; }
 
-        /// @brief Return as encoded bytes. 
-        std::vector<uint8_t> Bytes() const { return bytes; }
+        /// @brief Return a view of the encoded bytes. The view is valid for the lifetime of the item.
+        ByteView Bytes() const { return ByteView(data, length); }
+
+        /// @brief Returns true if this item is a dynamic array, a fixed-size array or a tuple.
+        bool IsList() const 
+        { 
+            return type == EncodableItemType::ItemArray || type == EncodableItemType::FixedArray || type == EncodableItemType::Tuple; 
+        }
 
         /// @brief Returns any sub-items of this is an array. 
-        std::vector<EncodableItem> Children() const { return children; }
+        const std::vector<EncodableItem> &Children() const { return children; }
 
         /// @brief Returns the encoded handle. This value is being used for ABI-encoding.
         const char* Handle() const { return handle; }
 
     private:
-        const EncodableItemType type;
-        const std::vector<uint8_t> bytes;
-        const std::vector<EncodableItem> children;
+        EncodableItem(EncodableItemType type, const char *handle) : type(type), handle(handle) { Store(nullptr, 0); }
+
+        static bool IsSignedHandle(const char *handle) { return strncmp(handle, "int", 3) == 0; }
+
+        static EncodableItemType BinaryType(const char *handle, size_t size)
+        {
+            if (strncmp(handle, "bytes", 5) != 0 || handle[5] == '\0') { return EncodableItemType::Binary; }
+            int length = atoi(handle + 5);
+            if (length < 1 || length > 32) { THROW("Invalid bytesN type."); }
+            if (size > (size_t)length) { THROW("Value exceeds the size of its bytesN type."); }
+            return EncodableItemType::FixedBytes;
+        }
+
+        static EncodableItemType ListType(const char *handle, size_t count)
+        {
+            // The array suffix is checked first, as arrays of tuples (e.g. "(uint256,address)[]") also start with '('.
+            const size_t length = strlen(handle);
+            if (length >= 2 && handle[length - 1] == ']' && handle[length - 2] == '[')
+            {
+                return EncodableItemType::ItemArray;
+            }
+            if (length >= 3 && handle[length - 1] == ']')
+            {
+                const char *bracket = strrchr(handle, '[');
+                if (bracket == nullptr || (size_t)atol(bracket + 1) != count) { THROW("Item count does not match the fixed-size array type."); }
+                return EncodableItemType::FixedArray;
+            }
+            return length > 0 && handle[0] == '(' ? EncodableItemType::Tuple : EncodableItemType::ItemArray;
+        }
+
+        /// @brief Returns the 32-byte two's complement representation after verifying that `value` fits in the `intN` type of `handle`.
+        static std::vector<uint8_t> SignedBytes(const BigNumber &value, const char *handle)
+        {
+            uint16_t bits = strlen(handle) > 3 ? atoi(handle + 3) : 256;
+            if (bits == 0 || bits > 256 || bits % 8 != 0) { THROW("Invalid signed integer type."); }
+            if (!value.FitsInBits(bits, true)) { THROW("Value out of range for signed integer type."); }
+            return value.TwosComplementBytes();
+        }
+
+        void StoreUnsigned(const BigNumber &value)
+        {
+            if (value.IsNegative()) { THROW("Negative values must be encoded using a signed handle (e.g. \"int256\")."); }
+            length = value.MinimalByteLength();
+            if (length <= ENCODABLE_INLINE_CAPACITY)
+            {
+                value.WriteMinimal(inlineBytes, length);
+                data = inlineBytes;
+                return;
+            }
+            heapBytes.resize(length);
+            value.WriteMinimal(heapBytes.data(), length);
+            data = heapBytes.data();
+        }
+
+        void Store(const uint8_t *bytes, size_t size)
+        {
+            length = size;
+            if (size <= ENCODABLE_INLINE_CAPACITY)
+            {
+                if (size > 0) { memcpy(inlineBytes, bytes, size); }
+                data = inlineBytes;
+                return;
+            }
+            heapBytes.assign(bytes, bytes + size);
+            data = heapBytes.data();
+        }
+
+        void Store(std::vector<uint8_t> &&bytes)
+        {
+            if (bytes.size() <= ENCODABLE_INLINE_CAPACITY)
+            {
+                Store(bytes.data(), bytes.size());
+                return;
+            }
+            length = bytes.size();
+            heapBytes = std::move(bytes);
+            data = heapBytes.data();
+        }
+
+        /// @brief Points `data` to this item's own copy of `other`'s storage. Borrowed data is shared.
+        void Rebase(const EncodableItem &other)
+        {
+            if (other.data == other.inlineBytes)
+            {
+                memcpy(inlineBytes, other.inlineBytes, length);
+                data = inlineBytes;
+            }
+            else if (!other.heapBytes.empty() && other.data == other.heapBytes.data())
+            {
+                data = heapBytes.data();
+            }
+            else
+            {
+                data = other.data;
+            }
+        }
+
+        EncodableItemType type;
+        std::vector<uint8_t> heapBytes;
+        std::vector<EncodableItem> children;
         const char *handle;
+        const uint8_t *data;
+        size_t length;
+        uint8_t inlineBytes[ENCODABLE_INLINE_CAPACITY];
     };
 
     /// @brief Interface for encoding `EncodableItem`'s
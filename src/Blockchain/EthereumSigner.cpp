@@ -52,27 +52,30 @@ namespace blockchain
         return EthereumSignature(pby, signature);
     }
 
-    EthereumTransaction EthereumSigner::Sign(const EthereumTransaction *transaction, const std::vector<uint8_t> *privateKey) const
+    EthereumSignature EthereumSigner::TransactionSignature(const EthereumTransaction *transaction, const std::vector<uint8_t> *privateKey) const
     {
-        std::vector<uint8_t> tx = transaction->Serialize();
-        if (transaction->Properties().signingStandard == EthereumSigningStandard::EIP1559)
-        {
-            tx.insert(tx.begin(), {0x2});
-        }
+        std::vector<uint8_t> hash = transaction->SigningHash();
 
-        std::vector<uint8_t> hash = Keccak256(&tx);
-
-        EthereumSignature signatureOriginal = EthereumSigner::GenerateSignature(&hash, privateKey);
-
-        uint32_t v = signatureOriginal.v;
+        EthereumSignature signature = EthereumSigner::GenerateSignature(&hash, privateKey);
 
         if (transaction->Properties().signingStandard == EthereumSigningStandard::Legacy)
         {
-            v = v + transaction->Properties().chainId * 2 + 0x23;
+            // EIP-155 or, without a chain id, the original 27/28.
+            uint32_t chainId = transaction->Properties().chainId;
+            signature.v = signature.v + (chainId != 0 ? chainId * 2 + 0x23 : 27);
         }
 
-        EthereumSignature signature = EthereumSignature(v, signatureOriginal.r, signatureOriginal.s);
+        return signature;
+    }
 
-        return EthereumTransaction(transaction->Properties(), signature);
+    EthereumTransaction EthereumSigner::Sign(const EthereumTransaction *transaction, const std::vector<uint8_t> *privateKey) const
+    {
+        return EthereumTransaction(*transaction, TransactionSignature(transaction, privateKey));
+    }
+
+    EthereumTransaction EthereumSigner::Sign(EthereumTransaction &&transaction, const std::vector<uint8_t> *privateKey) const
+    {
+        EthereumSignature signature = TransactionSignature(&transaction, privateKey);
+        return EthereumTransaction(std::move(transaction), std::move(signature));
     }
-}
\ No newline at end of file
+}
@@ -46,6 +46,12 @@ namespace blockchain
         /// @brief Sign an `EthereumTransaction` using a private key and return the signed `EthereumTransaction`.    
         EthereumTransaction Sign(const EthereumTransaction *transaction, const std::vector<uint8_t> *privateKey) const override;
 
+        /// @brief Sign an `EthereumTransaction` using a private key. The signed transaction takes over the properties and encoded fields of `transaction`.
+        EthereumTransaction Sign(EthereumTransaction &&transaction, const std::vector<uint8_t> *privateKey) const;
+
+        /// @brief Returns the signature of `transaction` (with `v` adjusted to its signing standard).
+        EthereumSignature TransactionSignature(const EthereumTransaction *transaction, const std::vector<uint8_t> *privateKey) const;
+
         EthereumSigner *clone() const override { return new EthereumSigner(*this); }
 
     private:
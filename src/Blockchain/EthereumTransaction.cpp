@@ -22,28 +22,574 @@
  * SOFTWARE.
  */
 
+#include <cstring>
+
 #include "EthereumTransaction.h"
+#include "EthereumSigner.h"
+#include "Account.h"
+#include "RlpDecoder.h"
+#include "../cryptography/sha3.h"
+#include "../cryptography/secp256k1.h"
+#include "../cryptography/ecdsa.h"
+
+#ifdef R2WEB3_THREADING_SUPPORTED
+#include <thread>
+#endif
+
+#define RLP_OFFSET_ITEM_SHORT 0x80
+#define RLP_OFFSET_ARRAY_SHORT 0xc0
+
+// `rlp(chainId) || rlp("") || rlp("")` with a chain id of up to 4 bytes.
+#define LEGACY_SIGNING_TAIL_SIZE (1 + 4 + 1 + 1)
 
 namespace blockchain
 {
-    std::vector<uint8_t> EthereumTransaction::Serialize() const
+    /// @brief Returns the RLP item of an EIP-2930 access list.
+    static EncodableItem accessListItem(const std::vector<AccessListEntry> &accessList)
+    {
+        std::vector<EncodableItem> entries;
+        entries.reserve(accessList.size());
+        for (const AccessListEntry &entry : accessList)
+        {
+            std::vector<EncodableItem> storageKeys;
+            storageKeys.reserve(entry.storageKeys.size());
+            for (const std::vector<uint8_t> &key : entry.storageKeys)
+            {
+                if (key.size() != 32)
+                {
+                    THROW("Access list storage keys must be 32 bytes.");
+                }
+                storageKeys.push_back(EncodableItem::Borrowed(key));
+            }
+            entries.push_back(EncodableItem({EncodableItem(&entry.address), EncodableItem(storageKeys)}));
+        }
+        return EncodableItem(entries);
+    }
+
+    /// @brief Returns the type prefix of typed transactions or 0 for legacy transactions.
+    static uint8_t transactionType(EthereumSigningStandard signingStandard)
+    {
+        switch (signingStandard)
+        {
+        case EthereumSigningStandard::EIP1559:
+            return 0x02;
+        case EthereumSigningStandard::EIP2930:
+            return 0x01;
+        default:
+            return 0x00;
+        }
+    }
+
+    /// @brief Hashes the signing payload `type || rlp-list-header || fields || tail` without assembling it.
+    static void hashSigningPayload(EthereumSigningStandard signingStandard, ByteView fields, ByteView tail, uint8_t *hash)
+    {
+        RlpEncoder encoder;
+        uint8_t header[1 + 1 + sizeof(size_t)];
+        size_t headerLength = 0;
+        if (signingStandard != EthereumSigningStandard::Legacy)
+        {
+            header[headerLength++] = transactionType(signingStandard);
+        }
+        headerLength += encoder.WriteListHeader(fields.size() + tail.size(), header + headerLength);
+
+        SHA3_CTX context;
+        keccak_256_Init(&context);
+        keccak_Update(&context, header, headerLength);
+        keccak_Update(&context, fields.data(), fields.size());
+        keccak_Update(&context, tail.data(), tail.size());
+        keccak_Final(&context, hash);
+    }
+
+    /// @brief Writes `rlp(chainId) || rlp("") || rlp("")`, which legacy transactions sign in place of the signature (EIP-155).
+    /// Transactions without a chain id sign no tail (pre EIP-155).
+    /// @return The number of bytes written.
+    static size_t writeLegacySigningTail(uint32_t chainId, uint8_t *tail)
+    {
+        if (chainId == 0)
+        {
+            return 0;
+        }
+        size_t length = 0;
+        if (chainId < RLP_OFFSET_ITEM_SHORT)
+        {
+            tail[length++] = (uint8_t)chainId;
+        }
+        else
+        {
+            uint8_t bytes = chainId > 0xFFFFFF ? 4 : chainId > 0xFFFF ? 3 : chainId > 0xFF ? 2 : 1;
+            tail[length++] = RLP_OFFSET_ITEM_SHORT + bytes;
+            for (uint8_t i = bytes; i > 0; i--)
+            {
+                tail[length++] = (uint8_t)(chainId >> ((i - 1) * 8));
+            }
+        }
+        tail[length++] = RLP_OFFSET_ITEM_SHORT;
+        tail[length++] = RLP_OFFSET_ITEM_SHORT;
+        return length;
+    }
+
+    /// @brief Recovers the address of the key that signed `hash`.
+    static bool recoverSender(const uint8_t *hash, ByteView r, ByteView s, uint8_t recoveryId, Address &sender)
+    {
+        if (r.size() > 32 || s.size() > 32 || recoveryId > 1)
+        {
+            return false;
+        }
+        uint8_t signature[ETHEREUM_SIGNATURE_LENGTH] = { 0 };
+        memcpy(signature + 32 - r.size(), r.data(), r.size());
+        memcpy(signature + ETHEREUM_SIGNATURE_LENGTH - s.size(), s.data(), s.size());
+
+        uint8_t publicKey[1 + ETH_PUBLIC_KEY_SIZE];
+        if (ecdsa_recover_pub_from_sig(&secp256k1, publicKey, signature, hash, recoveryId) != 0)
+        {
+            return false;
+        }
+        uint8_t publicKeyHash[KECCAK_256_LENGTH];
+        keccak_256(publicKey + 1, ETH_PUBLIC_KEY_SIZE, publicKeyHash);
+
+        const char *digits = "0123456789abcdef";
+        char address[ETH_ADDRESS_LENGTH + 1] = { '0', 'x' };
+        for (size_t i = 0; i < (ETH_ADDRESS_LENGTH - 2) / 2; i++)
+        {
+            uint8_t b = publicKeyHash[KECCAK_256_LENGTH - (ETH_ADDRESS_LENGTH - 2) / 2 + i];
+            address[2 + i * 2] = digits[b >> 4];
+            address[3 + i * 2] = digits[b & 0x0F];
+        }
+        sender = Address(address);
+        return true;
+    }
+
+    /// @brief A signed raw transaction split into its items. References the raw transaction.
+    struct RawTransaction
+    {
+        EthereumSigningStandard signingStandard;
+        /// @brief The items of the transaction, including the signature.
+        RlpItem items[12];
+        /// @brief The encoded items preceding the signature.
+        ByteView fields;
+        uint32_t chainId;
+        uint32_t v;
+        uint8_t recoveryId;
+        ByteView r;
+        ByteView s;
+    };
+
+    /// @brief Returns `true` if `item` is a string of at most `maxLength` bytes.
+    static bool isScalar(const RlpItem &item, size_t maxLength)
+    {
+        return !item.IsList() && item.Bytes().size() <= maxLength;
+    }
+
+    /// @brief Splits a signed raw transaction into its items and decodes its signature.
+    /// @return `nullptr` or a description of why `data` isn't a signed transaction.
+    static const char *parseRawTransaction(const uint8_t *data, size_t length, RawTransaction &raw)
+    {
+        if (length == 0)
+        {
+            return "Empty transaction.";
+        }
+
+        size_t itemCount, fieldCount, offset = 1;
+        if (data[0] >= RLP_OFFSET_ARRAY_SHORT)
+        {
+            raw.signingStandard = EthereumSigningStandard::Legacy;
+            itemCount = 9;
+            offset = 0;
+        }
+        else if (data[0] == transactionType(EthereumSigningStandard::EIP1559))
+        {
+            raw.signingStandard = EthereumSigningStandard::EIP1559;
+            itemCount = 12;
+        }
+        else if (data[0] == transactionType(EthereumSigningStandard::EIP2930))
+        {
+            raw.signingStandard = EthereumSigningStandard::EIP2930;
+            itemCount = 11;
+        }
+        else
+        {
+            return "Unsupported transaction type.";
+        }
+        fieldCount = itemCount - 3;
+
+        Result<RlpItem> decoded = RlpDecoder::Decode(data + offset, length - offset);
+        if (!decoded.HasValue() || !decoded.Value().IsList())
+        {
+            return "Invalid transaction encoding.";
+        }
+
+        size_t count = 0;
+        for (RlpItem item : decoded.Value())
+        {
+            if (count == itemCount)
+            {
+                return "Unexpected number of transaction fields.";
+            }
+            raw.items[count++] = item;
+        }
+        if (count != itemCount)
+        {
+            return "Unexpected number of transaction fields.";
+        }
+
+        const uint8_t *first = raw.items[0].Encoded().data();
+        ByteView last = raw.items[fieldCount - 1].Encoded();
+        raw.fields = ByteView(first, last.data() + last.size() - first);
+
+        const RlpItem &v = raw.items[itemCount - 3];
+        const RlpItem &r = raw.items[itemCount - 2];
+        const RlpItem &s = raw.items[itemCount - 1];
+        if (!isScalar(v, sizeof(uint64_t)) || !isScalar(r, 32) || !isScalar(s, 32) || r.Bytes().size() == 0 || s.Bytes().size() == 0)
+        {
+            return "Invalid signature.";
+        }
+        raw.r = r.Bytes();
+        raw.s = s.Bytes();
+
+        uint64_t value = v.ToUInt64();
+        uint64_t chainId;
+        if (raw.signingStandard == EthereumSigningStandard::Legacy)
+        {
+            if (value == 27 || value == 28)
+            {
+                chainId = 0;
+                raw.recoveryId = (uint8_t)(value - 27);
+            }
+            else if (value >= 37)
+            {
+                chainId = (value - 35) / 2;
+                raw.recoveryId = (uint8_t)((value - 35) % 2);
+            }
+            else if (value >= 35)
+            {
+                // EIP-155 with chain id 0, which can't be told apart from an unprotected transaction when hashing.
+                return "Unsupported chain id.";
+            }
+            else
+            {
+                return "Invalid signature.";
+            }
+        }
+        else
+        {
+            if (value > 1 || !isScalar(raw.items[0], sizeof(uint32_t)))
+            {
+                return "Invalid signature.";
+            }
+            chainId = raw.items[0].ToUInt64();
+            raw.recoveryId = (uint8_t)value;
+        }
+        if (chainId > UINT32_MAX || value > UINT32_MAX)
+        {
+            return "Unsupported chain id.";
+        }
+        raw.chainId = (uint32_t)chainId;
+        raw.v = (uint32_t)value;
+        return nullptr;
+    }
+
+    /// @brief Decodes an EIP-2930 access list.
+    static bool decodeAccessList(const RlpItem &item, std::vector<AccessListEntry> &accessList)
+    {
+        if (!item.IsList())
+        {
+            return false;
+        }
+        for (RlpItem entry : item)
+        {
+            if (!entry.IsList() || entry.Count() != 2)
+            {
+                return false;
+            }
+            RlpItem address = entry[0];
+            RlpItem storageKeys = entry[1];
+            if (address.IsList() || address.Bytes().size() != (ETH_ADDRESS_LENGTH - 2) / 2 || !storageKeys.IsList())
+            {
+                return false;
+            }
+            AccessListEntry decoded;
+            decoded.address = address.ToAddress();
+            for (RlpItem key : storageKeys)
+            {
+                if (key.IsList() || key.Bytes().size() != 32)
+                {
+                    return false;
+                }
+                decoded.storageKeys.push_back(key.Bytes().ToVector());
+            }
+            accessList.push_back(std::move(decoded));
+        }
+        return true;
+    }
+
+    void EthereumTransaction::EncodeFields()
     {
-        EncodableItem data({EncodableItem(properties.nonce),
-                            EncodableItem(&properties.gasPrice),
-                            EncodableItem(properties.gasLimit),
-                            EncodableItem(&properties.address),
-                            EncodableItem(&properties.value),
-                            EncodableItem(properties.data), 
-                            EncodableItem(signature.v), 
-                            EncodableItem(signature.r), 
-                            EncodableItem(signature.s)});
+        // Legacy: `rlp([nonce, gasPrice, gasLimit, to, value, data, v, r, s])`.
+        // Typed: `type || rlp([chainId, nonce, <fees>, gasLimit, to, value, data, accessList, (yParity, r, s)])`.
+        std::vector<EncodableItem> items;
+        items.reserve(9);
+        if (properties.signingStandard != EthereumSigningStandard::Legacy)
+        {
+            items.push_back(EncodableItem(properties.chainId));
+        }
+        items.push_back(EncodableItem(properties.nonce));
+        if (properties.signingStandard == EthereumSigningStandard::EIP1559)
+        {
+            items.push_back(EncodableItem(&properties.maxPriorityFeePerGas));
+            items.push_back(EncodableItem(&properties.maxFeePerGas));
+        }
+        else
+        {
+            items.push_back(EncodableItem(&properties.gasPrice));
+        }
+        items.push_back(EncodableItem(properties.gasLimit));
+        items.push_back(EncodableItem(&properties.address));
+        items.push_back(EncodableItem(&properties.value));
+        items.push_back(EncodableItem::Borrowed(properties.data));
+        if (properties.signingStandard != EthereumSigningStandard::Legacy)
+        {
+            items.push_back(accessListItem(properties.accessList));
+        }
+
+        size_t size = 0;
+        for (const EncodableItem &item : items)
+        {
+            size += encoder.EncodedSize(&item);
+        }
+        fields.resize(size);
+        size_t position = 0;
+        for (const EncodableItem &item : items)
+        {
+            position += encoder.Write(&item, fields.data() + position);
+        }
+    }
 
-        std::vector<uint8_t> encoded = encoder->Encode(&data);
+    std::vector<uint8_t> EthereumTransaction::EncodeSignature(const EthereumSignature &signature) const
+    {
+        // Unsigned legacy transactions without a chain id sign no tail (pre EIP-155), so they are serialized without one too.
+        const bool legacy = properties.signingStandard == EthereumSigningStandard::Legacy;
+        if (!signature.IsSigned() && (!legacy || properties.chainId == 0))
+        {
+            return std::vector<uint8_t>();
+        }
 
-        if(properties.signingStandard == EthereumSigningStandard::EIP1559) 
+        const EncodableItem items[] = {EncodableItem(signature.v), EncodableItem::Borrowed(signature.r), EncodableItem::Borrowed(signature.s)};
+        size_t size = 0;
+        for (const EncodableItem &item : items)
+        {
+            size += encoder.EncodedSize(&item);
+        }
+        std::vector<uint8_t> encoded(size);
+        size_t position = 0;
+        for (const EncodableItem &item : items)
         {
-            encoded.insert(encoded.begin(), 0x02);
+            position += encoder.Write(&item, encoded.data() + position);
         }
         return encoded;
     }
-}
\ No newline at end of file
+
+    size_t EthereumTransaction::SerializedSize(const std::vector<uint8_t> &encodedSignature) const
+    {
+        const size_t payloadLength = fields.size() + encodedSignature.size();
+        const size_t typeLength = properties.signingStandard == EthereumSigningStandard::Legacy ? 0 : 1;
+        return typeLength + encoder.ListHeaderSize(payloadLength) + payloadLength;
+    }
+
+    size_t EthereumTransaction::Write(const std::vector<uint8_t> &encodedSignature, uint8_t *buffer) const
+    {
+        size_t position = 0;
+        if (properties.signingStandard != EthereumSigningStandard::Legacy)
+        {
+            buffer[position++] = transactionType(properties.signingStandard);
+        }
+        position += encoder.WriteListHeader(fields.size() + encodedSignature.size(), buffer + position);
+        memcpy(buffer + position, fields.data(), fields.size());
+        position += fields.size();
+        if (!encodedSignature.empty())
+        {
+            memcpy(buffer + position, encodedSignature.data(), encodedSignature.size());
+        }
+        return position + encodedSignature.size();
+    }
+
+    std::vector<uint8_t> EthereumTransaction::Serialize() const
+    {
+        const std::vector<uint8_t> encodedSignature = EncodeSignature(signature);
+        std::vector<uint8_t> serialized(SerializedSize(encodedSignature));
+        Write(encodedSignature, serialized.data());
+        return serialized;
+    }
+
+    char *EthereumTransaction::SerializeHexString() const
+    {
+        const std::vector<uint8_t> encodedSignature = EncodeSignature(signature);
+        const size_t size = SerializedSize(encodedSignature);
+
+        // The bytes are written to the end of the string and expanded to hex front to back, which never overwrites unread bytes.
+        char *hex = new char[2 + size * 2 + 1];
+        uint8_t *bytes = (uint8_t *)hex + 2 + size;
+        Write(encodedSignature, bytes);
+
+        const char *digits = "0123456789abcdef";
+        hex[0] = '0';
+        hex[1] = 'x';
+        for (size_t i = 0; i < size; i++)
+        {
+            const uint8_t b = bytes[i];
+            hex[2 + i * 2] = digits[b >> 4];
+            hex[3 + i * 2] = digits[b & 0x0F];
+        }
+        hex[2 + size * 2] = '\0';
+        return hex;
+    }
+
+    std::vector<uint8_t> EthereumTransaction::SigningHash() const
+    {
+        uint8_t tail[LEGACY_SIGNING_TAIL_SIZE];
+        size_t tailLength = properties.signingStandard == EthereumSigningStandard::Legacy ? writeLegacySigningTail(properties.chainId, tail) : 0;
+        std::vector<uint8_t> hash(KECCAK_256_LENGTH);
+        hashSigningPayload(properties.signingStandard, ByteView(fields), ByteView(tail, tailLength), hash.data());
+        return hash;
+    }
+
+    std::vector<uint8_t> EthereumTransaction::Hash() const
+    {
+        std::vector<uint8_t> serialized = Serialize();
+        return Keccak256(&serialized);
+    }
+
+    Result<Address> EthereumTransaction::Sender() const
+    {
+        if (!signature.IsSigned())
+        {
+            return Result<Address>::Err(TRANSACTION_DECODE_ERROR, "The transaction is not signed.");
+        }
+
+        uint64_t offset = 0;
+        if (properties.signingStandard == EthereumSigningStandard::Legacy)
+        {
+            offset = properties.chainId != 0 ? (uint64_t)properties.chainId * 2 + 35 : 27;
+        }
+        if (signature.v < offset || signature.v - offset > 1)
+        {
+            return Result<Address>::Err(TRANSACTION_DECODE_ERROR, "Invalid signature.");
+        }
+
+        std::vector<uint8_t> hash = SigningHash();
+        Address sender;
+        if (!recoverSender(hash.data(), ByteView(signature.r), ByteView(signature.s), (uint8_t)(signature.v - offset), sender))
+        {
+            return Result<Address>::Err(TRANSACTION_DECODE_ERROR, "Unable to recover the sender.");
+        }
+        return sender;
+    }
+
+    Result<EthereumTransaction *> EthereumTransaction::Decode(const uint8_t *data, size_t length)
+    {
+        RawTransaction raw;
+        const char *error = parseRawTransaction(data, length, raw);
+        if (error != nullptr)
+        {
+            return Result<EthereumTransaction *>::Err(TRANSACTION_DECODE_ERROR, error);
+        }
+
+        // The items between the chain id (of typed transactions) and the access list are the same for all types,
+        // except for the fees: `gasPrice` or `maxPriorityFeePerGas, maxFeePerGas`.
+        const bool typed = raw.signingStandard != EthereumSigningStandard::Legacy;
+        const size_t feeCount = raw.signingStandard == EthereumSigningStandard::EIP1559 ? 2 : 1;
+        const RlpItem *item = raw.items + (typed ? 1 : 0);
+        const RlpItem &nonce = item[0];
+        const RlpItem *fees = item + 1;
+        const RlpItem &gasLimit = item[1 + feeCount];
+        const RlpItem &to = item[2 + feeCount];
+        const RlpItem &value = item[3 + feeCount];
+        const RlpItem &input = item[4 + feeCount];
+
+        bool valid = isScalar(nonce, sizeof(uint32_t)) && isScalar(gasLimit, sizeof(uint32_t)) && isScalar(value, 32) && 
+                     !input.IsList() && !to.IsList() && (to.Bytes().size() == 0 || to.Bytes().size() == (ETH_ADDRESS_LENGTH - 2) / 2);
+        for (size_t i = 0; i < feeCount; i++)
+        {
+            valid = valid && isScalar(fees[i], 32);
+        }
+
+        std::vector<AccessListEntry> accessList;
+        if (valid && typed)
+        {
+            valid = decodeAccessList(item[5 + feeCount], accessList);
+        }
+        if (!valid)
+        {
+            return Result<EthereumTransaction *>::Err(TRANSACTION_DECODE_ERROR, "Invalid transaction field.");
+        }
+
+        // Contract creations have no receiver, represented by the zero address.
+        Address receiver = to.Bytes().size() > 0 ? to.ToAddress() : Address();
+        std::vector<uint8_t> callData = input.Bytes().ToVector();
+        uint32_t n = (uint32_t)nonce.ToUInt64();
+        uint32_t limit = (uint32_t)gasLimit.ToUInt64();
+
+        EthereumTransactionProperties properties = 
+            raw.signingStandard == EthereumSigningStandard::EIP1559 ? 
+                EthereumTransactionProperties::EIP1559(n, fees[0].ToBigNumber(), fees[1].ToBigNumber(), limit, receiver, value.ToBigNumber(), 
+                                                       std::move(callData), raw.chainId, std::move(accessList)) :
+            raw.signingStandard == EthereumSigningStandard::EIP2930 ? 
+                EthereumTransactionProperties::EIP2930(n, fees[0].ToBigNumber(), limit, receiver, value.ToBigNumber(), 
+                                                       std::move(callData), raw.chainId, std::move(accessList)) :
+                EthereumTransactionProperties(n, fees[0].ToBigNumber(), limit, receiver, value.ToBigNumber(), std::move(callData), raw.chainId);
+
+        EthereumSignature signature(raw.v, raw.r.ToVector(), raw.s.ToVector());
+        return new EthereumTransaction(std::move(properties), std::move(signature), raw.fields.ToVector());
+    }
+
+    std::vector<RecoveredSender> EthereumTransaction::RecoverSenders(const std::vector<std::vector<uint8_t>> &transactions, uint8_t threads)
+    {
+        std::vector<RecoveredSender> results(transactions.size());
+
+        // Transactions are not materialized: the signing payload is hashed from the raw transaction.
+        auto recover = [&transactions, &results](size_t first, size_t last) {
+            for (size_t i = first; i < last; i++)
+            {
+                const std::vector<uint8_t> &transaction = transactions[i];
+                RecoveredSender &result = results[i];
+                result.recovered = false;
+                result.hash = Keccak256(&transaction);
+
+                RawTransaction raw;
+                if (parseRawTransaction(transaction.data(), transaction.size(), raw) != nullptr)
+                {
+                    continue;
+                }
+                uint8_t tail[LEGACY_SIGNING_TAIL_SIZE];
+                size_t tailLength = raw.signingStandard == EthereumSigningStandard::Legacy ? writeLegacySigningTail(raw.chainId, tail) : 0;
+                uint8_t hash[KECCAK_256_LENGTH];
+                hashSigningPayload(raw.signingStandard, raw.fields, ByteView(tail, tailLength), hash);
+                result.recovered = recoverSender(hash, raw.r, raw.s, raw.recoveryId, result.sender);
+            }
+        };
+
+    #ifdef R2WEB3_THREADING_SUPPORTED
+        size_t count = threads > 1 ? std::min((size_t)threads, transactions.size()) : 1;
+        if (count > 1)
+        {
+            // Contiguous ranges, so that each thread writes to its own part of `results`.
+            std::vector<std::thread> workers;
+            size_t share = transactions.size() / count;
+            size_t remainder = transactions.size() % count;
+            size_t first = 0;
+            for (size_t t = 0; t < count; t++)
+            {
+                size_t last = first + share + (t < remainder ? 1 : 0);
+                workers.push_back(std::thread(recover, first, last));
+                first = last;
+            }
+            for (std::thread &worker : workers)
+            {
+                worker.join();
+            }
+            return results;
+        }
+    #endif
+        recover(0, transactions.size());
+        return results;
+    }
+}
@@ -26,6 +26,7 @@
 #define __ETHEREUM_TRANSACTION_H__
 
 #include <vector>
+#include <utility>
 #include <stdint.h>
 
 #include "../Shared/BigNumber.h"
@@ -48,90 +49,234 @@ namespace blockchain
         /// @param v
         /// @param signature
         EthereumSignature(uint32_t v, const std::vector<uint8_t> signature)
-            : v(v),
-              r(std::vector<uint8_t>(signature.begin(), signature.begin() + signature.size() / 2) | byte_array::truncate),
-              s(std::vector<uint8_t>(signature.begin() + signature.size() / 2, signature.end()) | byte_array::truncate)
+            : r(std::vector<uint8_t>(signature.begin(), signature.begin() + signature.size() / 2) | byte_array::truncate),
+              s(std::vector<uint8_t>(signature.begin() + signature.size() / 2, signature.end()) | byte_array::truncate),
+              v(v)
 
         {}
 
-        EthereumSignature(uint32_t v, const std::vector<uint8_t> r, const std::vector<uint8_t> s) : v(v), r(r), s(s) {}
+        EthereumSignature(uint32_t v, const std::vector<uint8_t> r, const std::vector<uint8_t> s) : r(r), s(s), v(v) {}
 
-        const std::vector<uint8_t> r;
-        const std::vector<uint8_t> s;
-        const uint32_t v;
+        /// @brief Returns `false` for an "unsigned signature".
+        bool IsSigned() const { return !r.empty() || !s.empty(); }
+
+        std::vector<uint8_t> r;
+        std::vector<uint8_t> s;
+        uint32_t v;
+    };
+
+    /// @brief Error code returned when a raw transaction can't be decoded or its sender can't be recovered.
+    #define TRANSACTION_DECODE_ERROR -57
+
+    /// @brief The result of `EthereumTransaction::RecoverSenders` for one transaction.
+    struct RecoveredSender
+    {
+        /// @brief `false` if the transaction couldn't be decoded or its sender couldn't be recovered.
+        bool recovered;
+        Address sender;
+        /// @brief The transaction hash.
+        std::vector<uint8_t> hash;
     };
 
     /// @brief Signing standard being used for transactions.
     enum class EthereumSigningStandard
     {
+        /// @brief Legacy transactions, signed according to EIP-155.
         Legacy,
-        EIP1559 // also EIP-2930
+        /// @brief Type 0x02 transactions using `maxFeePerGas` and `maxPriorityFeePerGas`.
+        EIP1559,
+        /// @brief Type 0x01 transactions using `gasPrice` and an access list.
+        EIP2930
+    };
+
+    /// @brief An address and the storage slots a transaction is going to access (EIP-2930).
+    struct AccessListEntry
+    {
+        Address address;
+        /// @brief 32-byte storage keys.
+        std::vector<std::vector<uint8_t>> storageKeys;
+    };
+
+    /// @brief Fee parameters for an EIP-1559 transaction, e.g. from `Chain::SuggestFees`.
+    struct FeeSuggestion
+    {
+        /// @brief The base fee of the next block.
+        BigNumber baseFeePerGas;
+        BigNumber maxPriorityFeePerGas;
+        BigNumber maxFeePerGas;
     };
 
     /// @brief Represents the properties required for a transaction for Ethereum compatible chains.
     struct EthereumTransactionProperties
     {
+        /// @brief Creates a legacy transaction.
         EthereumTransactionProperties(uint32_t nonce, BigNumber gasPrice, uint32_t gasLimit,
                                       Address address, BigNumber value, std::vector<uint8_t> data,
-                                      uint32_t chainId) : nonce(nonce), gasPrice(gasPrice), gasLimit(gasLimit),
-                                                        address(address), value(value), data(data),
-                                                        chainId(chainId), signingStandard(EthereumSigningStandard::Legacy)
+                                      uint32_t chainId) : signingStandard(EthereumSigningStandard::Legacy), nonce(nonce), 
+                                                        gasPrice(std::move(gasPrice)), maxPriorityFeePerGas(0u), maxFeePerGas(0u),
+                                                        gasLimit(gasLimit), address(address), value(std::move(value)), 
+                                                        data(std::move(data)), chainId(chainId)
         {
             
         }
 
-        const EthereumSigningStandard signingStandard;
-        const uint32_t nonce;
-        const BigNumber gasPrice;
-        const uint32_t gasLimit;
-        const Address address;
-        const BigNumber value;
+        /// @brief Creates a type 0x02 (EIP-1559) transaction.
+        static EthereumTransactionProperties EIP1559(uint32_t nonce, BigNumber maxPriorityFeePerGas, BigNumber maxFeePerGas, uint32_t gasLimit,
+                                                     Address address, BigNumber value, std::vector<uint8_t> data, uint32_t chainId,
+                                                     std::vector<AccessListEntry> accessList = {})
+        {
+            return EthereumTransactionProperties(EthereumSigningStandard::EIP1559, nonce, BigNumber(0u), std::move(maxPriorityFeePerGas), 
+                                                 std::move(maxFeePerGas), gasLimit, address, std::move(value), std::move(data), chainId, 
+                                                 std::move(accessList));
+        }
+
+        /// @brief Creates a type 0x02 (EIP-1559) transaction using the fees of `fees`.
+        static EthereumTransactionProperties EIP1559(uint32_t nonce, const FeeSuggestion &fees, uint32_t gasLimit,
+                                                     Address address, BigNumber value, std::vector<uint8_t> data, uint32_t chainId,
+                                                     std::vector<AccessListEntry> accessList = {})
+        {
+            return EIP1559(nonce, fees.maxPriorityFeePerGas, fees.maxFeePerGas, gasLimit, address, std::move(value), std::move(data), chainId, 
+                           std::move(accessList));
+        }
+
+        /// @brief Creates a type 0x01 (EIP-2930) transaction.
+        static EthereumTransactionProperties EIP2930(uint32_t nonce, BigNumber gasPrice, uint32_t gasLimit,
+                                                     Address address, BigNumber value, std::vector<uint8_t> data, uint32_t chainId,
+                                                     std::vector<AccessListEntry> accessList)
+        {
+            return EthereumTransactionProperties(EthereumSigningStandard::EIP2930, nonce, std::move(gasPrice), BigNumber(0u), BigNumber(0u), 
+                                                 gasLimit, address, std::move(value), std::move(data), chainId, std::move(accessList));
+        }
+
+        // Not `const`, so that properties (and their data) can be moved.
+        EthereumSigningStandard signingStandard;
+        uint32_t nonce;
+        /// @brief Used by legacy and EIP-2930 transactions.
+        BigNumber gasPrice;
+        /// @brief Used by EIP-1559 transactions.
+        BigNumber maxPriorityFeePerGas;
+        /// @brief Used by EIP-1559 transactions.
+        BigNumber maxFeePerGas;
+        uint32_t gasLimit;
+        Address address;
+        BigNumber value;
         std::vector<uint8_t> data;
-        const uint32_t chainId;
+        uint32_t chainId;
+        /// @brief Used by EIP-1559 and EIP-2930 transactions.
+        std::vector<AccessListEntry> accessList;
+
+    private:
+        EthereumTransactionProperties(EthereumSigningStandard signingStandard, uint32_t nonce, BigNumber gasPrice, 
+                                      BigNumber maxPriorityFeePerGas, BigNumber maxFeePerGas, uint32_t gasLimit,
+                                      Address address, BigNumber value, std::vector<uint8_t> data, uint32_t chainId,
+                                      std::vector<AccessListEntry> accessList) : 
+                                      signingStandard(signingStandard), nonce(nonce), gasPrice(std::move(gasPrice)), 
+                                      maxPriorityFeePerGas(std::move(maxPriorityFeePerGas)), maxFeePerGas(std::move(maxFeePerGas)), gasLimit(gasLimit),
+                                      address(address), value(std::move(value)), data(std::move(data)), chainId(chainId), 
+                                      accessList(std::move(accessList)) {}
     };
 
     class EthereumTransaction : public Transaction
     {
     public:
-        /// @brief Cunstruct a transaction without a signature.
-        EthereumTransaction(EthereumTransactionProperties properties) : properties(properties), 
-                                                                        signature(EthereumSignature(properties.chainId)),
-                                                                        encoder(new RlpEncoder()) {}
-        /// @brief Cunstruct a transaction including a signature.
-        EthereumTransaction(EthereumTransactionProperties properties, EthereumSignature signature) : properties(properties),
-                                                                                                        signature(signature),
-                                                                                                        encoder(new RlpEncoder()) {}
-
-        EthereumTransaction(const EthereumTransaction& other) : properties(other.properties), 
-                                                                signature(other.signature), 
-                                                                encoder(other.encoder->clone()) {}
-
-        ~EthereumTransaction()
+        /// @brief Cunstruct a transaction without a signature. Pass an rvalue to avoid copying the properties.
+        EthereumTransaction(EthereumTransactionProperties properties) : signature(EthereumSignature(properties.chainId)),
+                                                                        properties(std::move(properties))
         {
-            delete encoder;
+            EncodeFields();
         }
 
-        EthereumTransaction &operator=(const EthereumTransaction &other)
+        /// @brief Cunstruct a transaction including a signature. Pass an rvalue to avoid copying the properties.
+        EthereumTransaction(EthereumTransactionProperties properties, EthereumSignature signature) : signature(std::move(signature)),
+                                                                                                        properties(std::move(properties))
         {
-            if (this != &other)
-            {
-                delete encoder;
-                encoder = other.encoder->clone();
-            }
-            return *this;
+            EncodeFields();
         }
 
-        /// @brief Serializes the transaction using the provided `encoder`.
+        /// @brief Construct a signed copy of `transaction`, reusing its encoded fields.
+        EthereumTransaction(const EthereumTransaction &transaction, EthereumSignature signature) : signature(std::move(signature)),
+                                                                                                     properties(transaction.properties),
+                                                                                                     fields(transaction.fields) {}
+
+        /// @brief Construct a signed transaction from `transaction`, taking over its properties and encoded fields.
+        EthereumTransaction(EthereumTransaction &&transaction, EthereumSignature signature) : signature(std::move(signature)),
+                                                                                                properties(std::move(transaction.properties)),
+                                                                                                fields(std::move(transaction.fields)) {}
+
+        EthereumTransaction(const EthereumTransaction &other) = default;
+        EthereumTransaction(EthereumTransaction &&other) = default;
+        EthereumTransaction &operator=(const EthereumTransaction &other) = default;
+        EthereumTransaction &operator=(EthereumTransaction &&other) = default;
+
+        /// @brief Serializes the transaction. Typed transactions are prefixed by their type.
+        /// An unsigned transaction is serialized as its signing payload.
         /// @return 
         std::vector<uint8_t> Serialize() const override;
 
-        EthereumTransactionProperties Properties() const { return properties; }
-        //void SetEncoder(Encoder encoder) : encoder(encoder) {}
+        /// @brief Serializes the transaction as a "0x"-prefixed, null-terminated hex string (e.g. for `eth_sendRawTransaction`) 
+        /// using a single allocation. Please note that the returned string needs to be deallocated manually.
+        /// @return
+        char *SerializeHexString() const;
+
+        /// @brief Returns the Keccak-256 hash of the signing payload (regardless of whether the transaction is signed).
+        /// @return
+        std::vector<uint8_t> SigningHash() const;
+
+        /// @brief Returns the transaction hash (the Keccak-256 hash of the serialized transaction).
+        /// @return
+        std::vector<uint8_t> Hash() const;
+
+        /// @brief Recovers the sender from the signature.
+        /// @return
+        Result<Address> Sender() const;
+
+        /// @brief Decodes a signed raw transaction (legacy, EIP-2930 or EIP-1559). The encoded fields are kept as they are, so the 
+        /// signing hash matches the signed data. Contract creations have a zero `address`. Legacy transactions protected with chain id 0
+        /// (`v` of 35 or 36) are rejected, as chain id 0 denotes unprotected transactions.
+        /// Please note that the returned transaction needs to be deleted manually.
+        /// @param data
+        /// @param length
+        /// @return
+        static Result<EthereumTransaction *> Decode(const uint8_t *data, size_t length);
+
+        /// @brief Decodes a signed raw transaction. See `Decode(const uint8_t *, size_t)`.
+        static Result<EthereumTransaction *> Decode(const std::vector<uint8_t> *data) { return Decode(data->data(), data->size()); }
+
+        /// @brief Recovers the senders of signed raw transactions, split between `threads` threads (on platforms supporting threads).
+        /// The transactions are not decoded into `EthereumTransaction`s: the signing hash is computed from the raw data.
+        /// @param transactions
+        /// @param threads
+        /// @return One result per transaction.
+        static std::vector<RecoveredSender> RecoverSenders(const std::vector<std::vector<uint8_t>> &transactions, uint8_t threads = 1);
+
+        const EthereumTransactionProperties &Properties() const { return properties; }
+
+        const EthereumSignature &Signature() const { return signature; }
 
     private:
-        const EthereumTransactionProperties properties;
-        const EthereumSignature signature;
-        EncoderX *encoder;
+        /// @brief Construct a transaction from its encoded fields (e.g. when decoding).
+        EthereumTransaction(EthereumTransactionProperties properties, EthereumSignature signature, std::vector<uint8_t> fields) : 
+            signature(std::move(signature)), properties(std::move(properties)), fields(std::move(fields)) {}
+
+        /// @brief Encodes the fields preceding the signature. Done once per transaction and shared by the signing payload and the signed transaction.
+        void EncodeFields();
+
+        /// @brief Returns the encoded signature fields following `fields` (none for unsigned typed transactions and unsigned legacy 
+        /// transactions without a chain id).
+        std::vector<uint8_t> EncodeSignature(const EthereumSignature &signature) const;
+
+        /// @brief Returns the size of the serialized transaction given the encoded signature fields.
+        size_t SerializedSize(const std::vector<uint8_t> &encodedSignature) const;
+
+        /// @brief Writes the serialized transaction given the encoded signature fields.
+        size_t Write(const std::vector<uint8_t> &encodedSignature, uint8_t *buffer) const;
+
+        // `signature` is initialized first, as it might depend on the chain id of properties being moved.
+        EthereumSignature signature;
+        EthereumTransactionProperties properties;
+        std::vector<uint8_t> fields;
+        /// @brief Stateless, kept by value.
+        RlpEncoder encoder;
 
     };
 }
@@ -53,28 +53,38 @@ namespace blockchain
         /// @return A signed `EthereumTransaction`
         EthereumTransaction GenerateTransaction(const EthereumTransactionProperties &properties, std::vector<uint8_t> *privateKey) const override
         {
-            EthereumTransaction t_unsigned(properties);
+            return signer->Sign(EthereumTransaction(properties), privateKey);
+        }
 
-            EthereumTransaction t_signed = signer->Sign(&t_unsigned, privateKey);
+        /// @brief Creates and signs a transaction, taking over `properties` instead of copying them.
+        /// @param properties Transaction information.
+        /// @param privateKey Key used to sign the transaction.
+        /// @return A signed `EthereumTransaction`
+        EthereumTransaction GenerateTransaction(EthereumTransactionProperties &&properties, std::vector<uint8_t> *privateKey) const
+        {
+            return signer->Sign(EthereumTransaction(std::move(properties)), privateKey);
+        }
 
-            return t_signed;
+        /// @brief Signs an unsigned transaction (e.g. from `TransactionBuilder::Build`), taking over its properties and encoded fields.
+        /// @param transaction An unsigned transaction.
+        /// @param privateKey Key used to sign the transaction.
+        /// @return A signed `EthereumTransaction`
+        EthereumTransaction SignTransaction(EthereumTransaction &&transaction, std::vector<uint8_t> *privateKey) const
+        {
+            return signer->Sign(std::move(transaction), privateKey);
         }
 
         /// @brief Uses the account's private key to create and sign an `EthereumTransaction`.
         /// @param properties The transaction data to be signed and serialied.
         /// @param account An account containing the signing key
         /// @return the signed transaction as a hex string. This result must be manually deallocated after usage.
-        char *GenerateSerializedData(const EthereumTransactionProperties properties, const Account *account) const override
+        char *GenerateSerializedData(const EthereumTransactionProperties &properties, const Account *account) const override
         {
             std::vector<uint8_t> pk = account->GetPrivateKey();
 
             EthereumTransaction tx = GenerateTransaction(properties, &pk);
 
-            std::vector<uint8_t> serializedTransaction = tx.Serialize();
-
-            char *parameter = (serializedTransaction | byte_array::hex_string) | char_string::add_hex_prefix;
-
-            return parameter;
+            return tx.SerializeHexString();
         }
 
         EthereumTransactionFactory &operator=(const EthereumTransactionFactory &other)
@@ -88,7 +98,7 @@ namespace blockchain
         }
 
     private:
-        const Signer<EthereumTransaction> *signer;
+        const EthereumSigner *signer;
     };
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,159 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2023 Tord Wessman
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef __EVENT_LOG_H__
+#define __EVENT_LOG_H__
+
+#include <vector>
+#include <cstdlib>
+#include <stdint.h>
+
+#include "../Shared/Common.h"
+#include "../Shared/cJSON.h"
+#include "Address.h"
+#include "TransactionResponse.h"
+#include "ContractABI.h"
+
+namespace blockchain
+{
+    /// Use as `LogFilter::toBlock` to query up to the latest block.
+    #define LOG_FILTER_LATEST_BLOCK UINT64_MAX
+
+    /// @brief Filter for `Chain::GetLogs`.
+    struct LogFilter
+    {
+        LogFilter(uint64_t fromBlock, uint64_t toBlock = LOG_FILTER_LATEST_BLOCK) : 
+            fromBlock(fromBlock), toBlock(toBlock), blockRange(2000), concurrency(1) {}
+
+        /// @brief Adds `topic` (`EVENT_TOPIC_SIZE` bytes) as an accepted value at `position` (0 is the event topic).
+        /// Multiple topics at the same position are alternatives. Positions without topics match anything.
+        LogFilter &AddTopic(size_t position, const uint8_t *topic)
+        {
+            if (position >= 4) { THROW("Logs have at most 4 topics."); }
+            if (topics.size() <= position) { topics.resize(position + 1); }
+            topics[position].push_back(std::vector<uint8_t>(topic, topic + EVENT_TOPIC_SIZE));
+            return *this;
+        }
+
+        /// @brief First block (inclusive).
+        uint64_t fromBlock;
+
+        /// @brief Last block (inclusive) or `LOG_FILTER_LATEST_BLOCK`.
+        uint64_t toBlock;
+
+        /// @brief Emitting contracts. Matches any contract if empty.
+        std::vector<Address> addresses;
+
+        /// @brief Accepted topics per position.
+        std::vector<std::vector<std::vector<uint8_t>>> topics;
+
+        /// @brief Number of blocks requested per `eth_getLogs` call. The range is halved whenever the provider rejects a request
+        /// for returning too many results.
+        uint32_t blockRange;
+
+        /// @brief Number of block ranges fetched in parallel. Only used if the `NetworkFacade` is thread-safe.
+        uint8_t concurrency;
+    };
+
+    /// @brief A log entry returned by `eth_getLogs`.
+    struct EventLog
+    {
+        /// @brief The emitting contract.
+        Address address;
+
+        /// @brief The topics, concatenated (`EVENT_TOPIC_SIZE` bytes each).
+        std::vector<uint8_t> topics;
+
+        /// @brief The non-indexed data.
+        std::vector<uint8_t> data;
+
+        uint64_t blockNumber;
+        uint32_t logIndex;
+        char transactionHash[ETH_HASH_SIZE + 2 + 1];
+
+        /// @brief True if the log was removed due to a chain reorganization.
+        bool removed;
+
+        /// @brief Returns the number of topics.
+        size_t TopicCount() const { return topics.size() / EVENT_TOPIC_SIZE; }
+
+        /// @brief Returns the topic at `index`.
+        const uint8_t *Topic(size_t index) const { return topics.data() + index * EVENT_TOPIC_SIZE; }
+
+        #define EventLog_Keys "address", "topics", "data", "blockNumber", "logIndex", "transactionHash"
+
+        static Result<EventLog *> Parse(cJSON *result)
+        {
+            for (const char *key : {EventLog_Keys})
+            {
+                if (!cJSON_HasObjectItem(result, key))
+                {
+                    return Result<EventLog *>::Err(-40, key);
+                }
+            }
+
+            EventLog *log = new EventLog();
+            log->address = Address(cJSON_GetObjectItemCaseSensitive(result, "address")->valuestring);
+            log->data = cJSON_GetObjectItemCaseSensitive(result, "data")->valuestring | byte_array::hex_string_to_bytes;
+            log->blockNumber = strtoull(cJSON_GetObjectItemCaseSensitive(result, "blockNumber")->valuestring, nullptr, 16);
+            log->logIndex = strtoul(cJSON_GetObjectItemCaseSensitive(result, "logIndex")->valuestring, nullptr, 16);
+            log->removed = cJSON_IsTrue(cJSON_GetObjectItemCaseSensitive(result, "removed"));
+
+            strncpy(log->transactionHash, cJSON_GetObjectItemCaseSensitive(result, "transactionHash")->valuestring, ETH_HASH_SIZE + 2);
+            log->transactionHash[ETH_HASH_SIZE + 2] = '\0';
+
+            cJSON *topic;
+            cJSON_ArrayForEach(topic, cJSON_GetObjectItemCaseSensitive(result, "topics"))
+            {
+                std::vector<uint8_t> bytes = topic->valuestring | byte_array::hex_string_to_bytes;
+                if (bytes.size() != EVENT_TOPIC_SIZE)
+                {
+                    delete log;
+                    return Result<EventLog *>::Err(-41, "topics");
+                }
+                log->topics.insert(log->topics.end(), bytes.begin(), bytes.end());
+            }
+            return log;
+        }
+    };
+
+    /// @brief A log decoded using a `ContractABI`.
+    struct DecodedEvent
+    {
+        /// @brief The raw log.
+        const EventLog *log;
+
+        /// @brief The matching event or `nullptr` if the log could not be decoded.
+        const ABIEvent *event;
+
+        /// @brief The indexed parameters (references `log`).
+        ABIValue indexed;
+
+        /// @brief The non-indexed parameters (references `log`).
+        ABIValue data;
+    };
+}
+
+#endif
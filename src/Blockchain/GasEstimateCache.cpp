@@ -0,0 +1,131 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2023 Tord Wessman
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstring>
+
+#include "GasEstimateCache.h"
+
+namespace blockchain
+{
+    static bool sameAddress(const Address &a, const Address &b)
+    {
+        return strcasecmp(a.AsString(), b.AsString()) == 0;
+    }
+
+    bool GasEstimateCache::Find(const Address &to, const std::vector<uint8_t> &data, bool hasValue, uint32_t &gasLimit) const
+    {
+        uint32_t shape = Shape(data, hasValue);
+    #ifdef R2WEB3_THREADING_SUPPORTED
+        std::lock_guard<std::mutex> lock(mutex);
+    #endif
+        for (const Entry &entry : entries)
+        {
+            if (entry.shape == shape && entry.length == data.size() && sameAddress(entry.to, to))
+            {
+                gasLimit = entry.gasLimit;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint32_t GasEstimateCache::Insert(const Address &to, const std::vector<uint8_t> &data, bool hasValue, uint32_t estimate)
+    {
+        Entry entry;
+        entry.shape = Shape(data, hasValue);
+        entry.to = to;
+        entry.length = data.size();
+        entry.gasLimit = WithMargin(estimate);
+    #ifdef R2WEB3_THREADING_SUPPORTED
+        std::lock_guard<std::mutex> lock(mutex);
+    #endif
+        for (Entry &existing : entries)
+        {
+            if (existing.shape == entry.shape && existing.length == entry.length && sameAddress(existing.to, to))
+            {
+                existing.gasLimit = entry.gasLimit;
+                return entry.gasLimit;
+            }
+        }
+        if (capacity == 0)
+        {
+            return entry.gasLimit;
+        }
+        if (entries.size() < capacity)
+        {
+            entries.push_back(entry);
+        }
+        else
+        {
+            entries[next] = entry;
+            next = (next + 1) % capacity;
+        }
+        return entry.gasLimit;
+    }
+
+    uint32_t GasEstimateCache::WithMargin(uint32_t estimate) const
+    {
+        uint64_t gasLimit = (uint64_t)estimate * (100 + marginPercent) / 100 + marginGas;
+        return gasLimit > UINT32_MAX ? UINT32_MAX : (uint32_t)gasLimit;
+    }
+
+    void GasEstimateCache::Clear()
+    {
+    #ifdef R2WEB3_THREADING_SUPPORTED
+        std::lock_guard<std::mutex> lock(mutex);
+    #endif
+        entries.clear();
+        next = 0;
+    }
+
+    uint32_t GasEstimateCache::Shape(const std::vector<uint8_t> &data, bool hasValue)
+    {
+        uint32_t hash = 2166136261u;
+        hash = (hash ^ (hasValue ? 1 : 0)) * 16777619u;
+
+        size_t selectorLength = data.size() < 4 ? data.size() : 4;
+        for (size_t i = 0; i < selectorLength; i++)
+        {
+            hash = (hash ^ data[i]) * 16777619u;
+        }
+
+        // Writing a zero or non-zero value (e.g. to a fresh storage slot) differs in cost, while the value itself rarely matters.
+        for (size_t word = selectorLength; word < data.size(); word += 32)
+        {
+            size_t end = word + 32 < data.size() ? word + 32 : data.size();
+            uint8_t zero = 1;
+            for (size_t i = word; i < end; i++)
+            {
+                if (data[i] != 0)
+                {
+                    zero = 0;
+                    break;
+                }
+            }
+            hash = (hash ^ zero) * 16777619u;
+        }
+        return hash;
+    }
+}
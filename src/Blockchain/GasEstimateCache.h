@@ -0,0 +1,94 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2023 Tord Wessman
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef __GAS_ESTIMATE_CACHE_H__
+#define __GAS_ESTIMATE_CACHE_H__
+
+#include <vector>
+#include <stdint.h>
+
+#include "../Shared/Common.h"
+#include "Address.h"
+
+#ifdef R2WEB3_THREADING_SUPPORTED
+#include <mutex>
+#endif
+
+namespace blockchain
+{
+    /// Default safety margin (in percent) added to cached gas estimates.
+    #define GAS_ESTIMATE_MARGIN_PERCENT 20
+
+    /// Default number of estimates kept by a `GasEstimateCache`.
+    #define GAS_ESTIMATE_CACHE_CAPACITY 32
+
+    /// @brief Caches gas estimates of repeated operations (see `Chain::EstimateGas`). Estimates are keyed by the receiver, the function
+    /// selector and the "shape" of the call: the length of the call data, which of its 32-byte words are zero and whether a value is sent.
+    /// Calls with the same shape (e.g. token transfers of different amounts to different addresses) usually require similar gas. A safety
+    /// margin is added to the estimates, covering the differences as well as state changes between estimating and sending.
+    class GasEstimateCache
+    {
+    public:
+        /// @param marginPercent Added to the estimates, in percent.
+        /// @param marginGas Added to the estimates, in gas (after `marginPercent`).
+        /// @param capacity The maximum number of estimates. The oldest estimate is replaced when full.
+        GasEstimateCache(uint8_t marginPercent = GAS_ESTIMATE_MARGIN_PERCENT, uint32_t marginGas = 0, size_t capacity = GAS_ESTIMATE_CACHE_CAPACITY) 
+            : marginPercent(marginPercent), marginGas(marginGas), capacity(capacity), next(0) {}
+
+        /// @brief Copies the gas limit (including the safety margin) of a call with the same shape to `gasLimit`. Returns `false` if not cached.
+        bool Find(const Address &to, const std::vector<uint8_t> &data, bool hasValue, uint32_t &gasLimit) const;
+
+        /// @brief Caches `estimate` and returns the gas limit including the safety margin.
+        uint32_t Insert(const Address &to, const std::vector<uint8_t> &data, bool hasValue, uint32_t estimate);
+
+        /// @brief Returns `estimate` including the safety margin.
+        uint32_t WithMargin(uint32_t estimate) const;
+
+        /// @brief Removes all estimates, e.g. after a contract has been upgraded.
+        void Clear();
+
+    private:
+        struct Entry
+        {
+            uint32_t shape;
+            Address to;
+            size_t length;
+            uint32_t gasLimit;
+        };
+
+        /// @brief FNV-1a of the selector, the zero words and `hasValue`.
+        static uint32_t Shape(const std::vector<uint8_t> &data, bool hasValue);
+
+        const uint8_t marginPercent;
+        const uint32_t marginGas;
+        const size_t capacity;
+        std::vector<Entry> entries;
+        size_t next;
+    #ifdef R2WEB3_THREADING_SUPPORTED
+        mutable std::mutex mutex;
+    #endif
+    };
+}
+#endif
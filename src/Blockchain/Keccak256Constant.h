@@ -0,0 +1,130 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2023 Tord Wessman
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef __KECCAK256_CONSTANT_H__
+#define __KECCAK256_CONSTANT_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Compile-time hashing relies on C++14 `constexpr` (loops and local variables).
+#if __cplusplus >= 201402L
+
+namespace blockchain
+{
+    /// @brief A Keccak-256 digest that can be computed at compile time (e.g. for function selectors and event topics).
+    /// Use `Keccak256` (Signer.h) for runtime hashing.
+    struct Keccak256Constant
+    {
+        /// @brief Hashes `length` bytes of `data`.
+        static constexpr Keccak256Constant Hash(const char *data, size_t length)
+        {
+            uint64_t state[25] = {};
+            const size_t rate = 136;
+            size_t offset = 0;
+
+            // Absorb full blocks, then the final block padded with 0x01 ... 0x80.
+            while (true)
+            {
+                uint8_t block[rate] = {};
+                size_t remaining = length - offset;
+                size_t count = remaining < rate ? remaining : rate;
+                for (size_t i = 0; i < count; i++) { block[i] = (uint8_t)data[offset + i]; }
+                bool last = remaining < rate;
+                if (last)
+                {
+                    block[count] ^= 0x01;
+                    block[rate - 1] ^= 0x80;
+                }
+
+                for (size_t i = 0; i < rate / 8; i++)
+                {
+                    uint64_t lane = 0;
+                    for (size_t j = 0; j < 8; j++) { lane |= (uint64_t)block[i * 8 + j] << (8 * j); }
+                    state[i] ^= lane;
+                }
+                Permute(state);
+
+                if (last) { break; }
+                offset += rate;
+            }
+
+            Keccak256Constant digest;
+            for (size_t i = 0; i < 32; i++) { digest.bytes[i] = (uint8_t)(state[i / 8] >> (8 * (i % 8))); }
+            return digest;
+        }
+
+        constexpr Keccak256Constant() : bytes{} {}
+
+        constexpr uint8_t operator[](size_t index) const { return bytes[index]; }
+
+        uint8_t bytes[32];
+
+    private:
+        static constexpr uint64_t RotateLeft(uint64_t value, unsigned shift)
+        {
+            return shift == 0 ? value : (value << shift) | (value >> (64 - shift));
+        }
+
+        /// @brief The Keccak-f[1600] permutation.
+        static constexpr void Permute(uint64_t (&a)[25])
+        {
+            const uint64_t roundConstants[24] = {
+                0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL, 0x8000000080008000ULL,
+                0x000000000000808BULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+                0x000000000000008AULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+                0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+                0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800AULL, 0x800000008000000AULL,
+                0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL};
+            const unsigned rotations[25] = {0, 1, 62, 28, 27, 36, 44, 6, 55, 20, 3, 10, 43, 25, 39, 41, 45, 15, 21, 8, 18, 2, 61, 56, 14};
+
+            for (size_t round = 0; round < 24; round++)
+            {
+                uint64_t c[5] = {};
+                for (size_t x = 0; x < 5; x++) { c[x] = a[x] ^ a[x + 5] ^ a[x + 10] ^ a[x + 15] ^ a[x + 20]; }
+                for (size_t x = 0; x < 5; x++)
+                {
+                    uint64_t d = c[(x + 4) % 5] ^ RotateLeft(c[(x + 1) % 5], 1);
+                    for (size_t y = 0; y < 25; y += 5) { a[x + y] ^= d; }
+                }
+
+                uint64_t b[25] = {};
+                for (size_t x = 0; x < 5; x++)
+                {
+                    for (size_t y = 0; y < 5; y++) { b[y + 5 * ((2 * x + 3 * y) % 5)] = RotateLeft(a[x + 5 * y], rotations[x + 5 * y]); }
+                }
+
+                for (size_t x = 0; x < 5; x++)
+                {
+                    for (size_t y = 0; y < 25; y += 5) { a[x + y] = b[x + y] ^ (~b[(x + 1) % 5 + y] & b[(x + 2) % 5 + y]); }
+                }
+                a[0] ^= roundConstants[round];
+            }
+        }
+    };
+}
+
+#endif
+#endif
@@ -0,0 +1,228 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2023 Tord Wessman
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstring>
+
+#include "RlpDecoder.h"
+
+namespace blockchain
+{
+    #define RLP_LENGTH_THRESHOLD 0x37
+    #define RLP_OFFSET_ITEM_SHORT 0x80
+    #define RLP_OFFSET_ITEM_LONG 0xb7
+    #define RLP_OFFSET_ARRAY_SHORT 0xc0
+    #define RLP_OFFSET_ARRAY_LONG 0xf7
+
+    /// @brief Reads the header at `data`. Returns false if the header is truncated or not in its canonical (shortest) form.
+    static bool readHeader(const uint8_t *data, size_t available, size_t &headerLength, size_t &payloadLength, bool &list)
+    {
+        if (available == 0) { return false; }
+
+        const uint8_t prefix = data[0];
+        size_t lengthOfLength;
+        if (prefix < RLP_OFFSET_ITEM_SHORT)
+        {
+            // A single byte is its own encoding.
+            headerLength = 0;
+            payloadLength = 1;
+            list = false;
+            return true;
+        }
+        else if (prefix <= RLP_OFFSET_ITEM_LONG)
+        {
+            headerLength = 1;
+            payloadLength = prefix - RLP_OFFSET_ITEM_SHORT;
+            list = false;
+            // Single bytes below 0x80 must not have a header.
+            return !(payloadLength == 1 && available > 1 && data[1] < RLP_OFFSET_ITEM_SHORT);
+        }
+        else if (prefix < RLP_OFFSET_ARRAY_SHORT)
+        {
+            lengthOfLength = prefix - RLP_OFFSET_ITEM_LONG;
+            list = false;
+        }
+        else if (prefix <= RLP_OFFSET_ARRAY_LONG)
+        {
+            headerLength = 1;
+            payloadLength = prefix - RLP_OFFSET_ARRAY_SHORT;
+            list = true;
+            return true;
+        }
+        else
+        {
+            lengthOfLength = prefix - RLP_OFFSET_ARRAY_LONG;
+            list = true;
+        }
+
+        if (lengthOfLength > sizeof(size_t) || available < 1 + lengthOfLength || data[1] == 0)
+        {
+            return false;
+        }
+
+        size_t length = 0;
+        for (size_t i = 0; i < lengthOfLength; i++)
+        {
+            length = (length << 8) | data[1 + i];
+        }
+        headerLength = 1 + lengthOfLength;
+        payloadLength = length;
+        return length > RLP_LENGTH_THRESHOLD;
+    }
+
+    RlpItem RlpItem::At(const uint8_t *data)
+    {
+        size_t headerLength, payloadLength;
+        bool list;
+        readHeader(data, SIZE_MAX, headerLength, payloadLength, list);
+        return RlpItem(data, headerLength, payloadLength, list);
+    }
+
+    void RlpItem::AssertKind(bool valid) const
+    {
+        if (data == nullptr || !valid)
+        {
+            THROW("RlpItem has an incompatible type.");
+        }
+    }
+
+    ByteView RlpItem::Bytes() const
+    {
+        AssertKind(!list);
+        return Payload();
+    }
+
+    size_t RlpItem::Count() const
+    {
+        AssertKind(list);
+        size_t count = 0;
+        for (Iterator it = begin(); it != end(); ++it) { count++; }
+        return count;
+    }
+
+    RlpItem RlpItem::operator[](size_t index) const
+    {
+        AssertKind(list);
+        Iterator it = begin();
+        for (size_t i = 0; i < index && it != end(); i++) { ++it; }
+        if (it == end())
+        {
+            THROW("RlpItem index out of range.");
+        }
+        return *it;
+    }
+
+    RlpItem::Iterator RlpItem::begin() const
+    {
+        AssertKind(list);
+        return Iterator(data + headerLength);
+    }
+
+    RlpItem::Iterator RlpItem::end() const
+    {
+        AssertKind(list);
+        return Iterator(data + headerLength + payloadLength);
+    }
+
+    BigNumber RlpItem::ToBigNumber() const
+    {
+        AssertKind(!list && payloadLength <= 32);
+        return BigNumber::FromBigEndian(data + headerLength, payloadLength);
+    }
+
+    uint64_t RlpItem::ToUInt64() const
+    {
+        AssertKind(!list && payloadLength <= sizeof(uint64_t));
+        uint64_t value = 0;
+        for (size_t i = 0; i < payloadLength; i++)
+        {
+            value = (value << 8) | data[headerLength + i];
+        }
+        return value;
+    }
+
+    Address RlpItem::ToAddress() const
+    {
+        AssertKind(!list && payloadLength == (ETH_ADDRESS_LENGTH - 2) / 2);
+        const char *digits = "0123456789abcdef";
+        char address[ETH_ADDRESS_LENGTH + 1] = { '0', 'x' };
+        for (size_t i = 0; i < payloadLength; i++)
+        {
+            uint8_t b = data[headerLength + i];
+            address[2 + i * 2] = digits[b >> 4];
+            address[3 + i * 2] = digits[b & 0x0F];
+        }
+        return Address(address);
+    }
+
+    bool RlpDecoder::Validate(const uint8_t *data, size_t available, uint8_t depth, size_t &length)
+    {
+        size_t headerLength, payloadLength;
+        bool list;
+        if (!readHeader(data, available, headerLength, payloadLength, list) || payloadLength > available - headerLength)
+        {
+            return false;
+        }
+
+        length = headerLength + payloadLength;
+        if (!list)
+        {
+            return true;
+        }
+        if (depth >= RLP_MAX_DEPTH)
+        {
+            return false;
+        }
+
+        size_t position = headerLength;
+        while (position < length)
+        {
+            size_t itemLength;
+            if (!Validate(data + position, length - position, depth + 1, itemLength))
+            {
+                return false;
+            }
+            position += itemLength;
+        }
+        return true;
+    }
+
+    Result<RlpItem> RlpDecoder::Decode(const uint8_t *data, size_t length, size_t *consumed)
+    {
+        size_t itemLength;
+        if (data == nullptr || !Validate(data, length, 0, itemLength))
+        {
+            return Result<RlpItem>::Err(RLP_DECODE_ERROR, "Invalid RLP data.");
+        }
+        if (consumed != nullptr)
+        {
+            *consumed = itemLength;
+        }
+        else if (itemLength != length)
+        {
+            return Result<RlpItem>::Err(RLP_DECODE_ERROR, "Unexpected data after RLP item.");
+        }
+        return Result<RlpItem>(RlpItem::At(data));
+    }
+}
@@ -0,0 +1,138 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2023 Tord Wessman
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef __RLP_DECODER_H__
+#define __RLP_DECODER_H__
+
+#include <vector>
+#include <stdint.h>
+
+#include "../Shared/Common.h"
+#include "../Shared/BigNumber.h"
+#include "Address.h"
+
+namespace blockchain
+{
+    #define RLP_DECODE_ERROR -54
+
+    /// Maximum list nesting accepted by `RlpDecoder`.
+    #define RLP_MAX_DEPTH 32
+
+    /// @brief A view of an item in RLP-encoded data, obtained from `RlpDecoder::Decode`. Either a string (a byte array) or a list.
+    /// No data is copied: the item references the encoded data, which must outlive it.
+    class RlpItem
+    {
+    public:
+        /// @brief Iterates the items of a list without materializing them.
+        class Iterator
+        {
+        public:
+            RlpItem operator*() const { return RlpItem::At(position); }
+            Iterator &operator++() { position += RlpItem::At(position).Encoded().size(); return *this; }
+            bool operator!=(const Iterator &other) const { return position != other.position; }
+            bool operator==(const Iterator &other) const { return position == other.position; }
+
+        private:
+            friend class RlpItem;
+            explicit Iterator(const uint8_t *position) : position(position) {}
+            const uint8_t *position;
+        };
+
+        /// @brief Creates an empty string item.
+        RlpItem() : data(nullptr), headerLength(0), payloadLength(0), list(false) {}
+
+        /// @brief Returns `true` if the item is a list.
+        bool IsList() const { return list; }
+
+        /// @brief Returns the contents of a string item.
+        ByteView Bytes() const;
+
+        /// @brief Returns the payload (the contents of a string or the concatenated, encoded items of a list).
+        ByteView Payload() const { return ByteView(data + headerLength, payloadLength); }
+
+        /// @brief Returns the complete encoding of the item, including its header (e.g. for hashing).
+        ByteView Encoded() const { return ByteView(data, headerLength + payloadLength); }
+
+        /// @brief Returns the number of items in a list. Walks the list.
+        size_t Count() const;
+
+        /// @brief Returns an item of a list. Walks the list up to `index`; use `begin()`/`end()` to visit all items.
+        /// @param index Must be less than `Count()`.
+        /// @return
+        RlpItem operator[](size_t index) const;
+
+        /// @brief Returns an iterator to the first item of a list.
+        Iterator begin() const;
+
+        /// @brief Returns an iterator past the last item of a list.
+        Iterator end() const;
+
+        /// @brief Returns a string item of at most 32 bytes as an unsigned big-endian integer.
+        BigNumber ToBigNumber() const;
+
+        /// @brief Returns a string item of at most 8 bytes as an unsigned big-endian integer.
+        uint64_t ToUInt64() const;
+
+        /// @brief Returns a 20-byte string item as an `Address`.
+        Address ToAddress() const;
+
+    private:
+        friend class RlpDecoder;
+        RlpItem(const uint8_t *data, size_t headerLength, size_t payloadLength, bool list) : 
+            data(data), headerLength(headerLength), payloadLength(payloadLength), list(list) {}
+
+        /// @brief Reads the (already validated) item starting at `data`.
+        static RlpItem At(const uint8_t *data);
+
+        void AssertKind(bool valid) const;
+
+        const uint8_t *data;
+        size_t headerLength;
+        size_t payloadLength;
+        bool list;
+    };
+
+    /// @brief Decodes RLP data (e.g. signed transactions, receipts or block headers).
+    class RlpDecoder
+    {
+    public:
+        /// @brief Decodes the item at the start of `data`. All headers and lengths are validated up front (including that the 
+        /// encoding is canonical), so the returned item can be traversed without further checks. No data is copied.
+        /// @param data 
+        /// @param length The number of bytes in `data`.
+        /// @param consumed If not null, receives the size of the decoded item and trailing data is allowed (e.g. when reading
+        ///                 consecutive items from a stream). Otherwise the item must span all of `data`.
+        /// @return The decoded item or `RLP_DECODE_ERROR` if `data` is not valid RLP.
+        static Result<RlpItem> Decode(const uint8_t *data, size_t length, size_t *consumed = nullptr);
+
+        /// @brief Decodes `data`. See `Decode(const uint8_t *, size_t, size_t *)`.
+        static Result<RlpItem> Decode(const std::vector<uint8_t> *data) { return Decode(data->data(), data->size()); }
+
+    private:
+        static bool Validate(const uint8_t *data, size_t available, uint8_t depth, size_t &length);
+    };
+}
+
+#endif
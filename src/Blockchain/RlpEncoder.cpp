@@ -23,6 +23,7 @@
  */
 
 #include <cassert>
+#include <cstring>
 
 #include "RlpEncoder.h"
 #include "../Shared/Common.h"
@@ -36,114 +37,116 @@ namespace blockchain
     #define RLP_OFFSET_ITEM_LONG 0xb7
     #define RLP_MAX_LENGTH 0xff - RLP_OFFSET_ARRAY_LONG
 
-    // Packs the length information into an RLP header
-    std::vector<uint8_t> generateHeader(const size_t length)
+    /// @brief Returns the number of bytes needed to represent `length` in big-endian without leading zeros.
+    static size_t lengthOfLength(size_t length)
     {
-        std::vector<uint8_t> header;
-        size_t tmp = length;
-        while ((uint32_t)(tmp / 0x100) > 0)
-        {
-            header.push_back((uint8_t)(tmp % 0x100));
-            tmp = (uint32_t)(tmp / 0x100);
-        }
-        header.push_back((uint8_t)(tmp));
-        header.insert(header.begin(), RLP_OFFSET_ITEM_LONG + header.size());
-        return header;
+        size_t count = 0;
+        for (; length > 0; length >>= 8) { count++; }
+        return count;
     }
 
-    // Reverse order of the original header
-    std::vector<uint8_t> reverseHeader(const std::vector<uint8_t> originalHeader)
+    /// @brief Returns the size of the header preceding a string or list payload of `length` bytes.
+    static size_t headerLength(const size_t length)
     {
-        assert(originalHeader.size() > 0);
-
-        std::vector<uint8_t> header;
-        header.push_back(originalHeader[0]);
-        const uint8_t hex = originalHeader.size() - 1;
-        for (int i = 0; i < hex; i++)
-        {
-            header.push_back(originalHeader[hex - i]);
-        }
-        return header;
+        return length <= RLP_LENGTH_THRESHOLD ? 1 : 1 + lengthOfLength(length);
     }
 
-    std::vector<uint8_t> RlpEncoder::Encode(const EncodableItem *item) const
+    /// @brief Writes the header of a payload of `length` bytes. `shortOffset` and `longOffset` are the string or list offsets.
+    static size_t writeHeader(uint8_t *buffer, const size_t length, const uint8_t shortOffset, const uint8_t longOffset)
     {
-        if (item->Type() == EncodableItemType::ItemArray)
+        if (length <= RLP_LENGTH_THRESHOLD)
         {
-            assert(item->Bytes().size() == 0);
-            std::vector<EncodableItem> children = item->Children();
-            return EncodeVector(&children);
+            buffer[0] = shortOffset + (uint8_t)length;
+            return 1;
         }
-        else
+
+        const size_t count = lengthOfLength(length);
+        assert(count < RLP_MAX_LENGTH);
+        buffer[0] = longOffset + (uint8_t)count;
+        for (size_t i = 0; i < count; i++)
         {
-            assert(item->Children().size() == 0);
-            std::vector<uint8_t> bytes = item->Bytes();
-            return EncodeBytes(&bytes);   
+            buffer[count - i] = (uint8_t)(length >> (i * 8));
         }
+        return 1 + count;
+    }
+
+    /// @brief Returns `true` if `bytes` is encoded as itself, without a header.
+    static bool isSingleByte(const ByteView &bytes)
+    {
+        // A single 0x00 is encoded as the empty string (i.e. the integer 0).
+        return bytes.size() == 1 && bytes[0] != 0x00 && bytes[0] < RLP_OFFSET_ITEM_SHORT;
     }
 
-    std::vector<uint8_t> RlpEncoder::EncodeVector(const std::vector<EncodableItem> *items) const
+    std::vector<uint8_t> RlpEncoder::Encode(const EncodableItem *item) const
     {
-        std::vector<uint8_t> encoded;
+        std::vector<uint8_t> encoded(EncodedSize(item));
+        Write(item, encoded.data());
+        return encoded;
+    }
 
-        for (EncodableItem item : *items)
+    size_t RlpEncoder::EncodedSize(const EncodableItem *item) const
+    {
+        if (!item->IsList() && isSingleByte(item->Bytes()))
         {
-            std::vector<uint8_t> itemBytes = Encode(&item);
-            encoded.insert(encoded.end(), itemBytes.begin(), itemBytes.end());
+            return 1;
         }
+        const size_t length = PayloadSize(item);
+        return headerLength(length) + length;
+    }
 
-        size_t combinedCount = encoded.size();
-
-        if (combinedCount <= RLP_LENGTH_THRESHOLD)
-        {
-            const uint8_t sign = RLP_OFFSET_ARRAY_SHORT + (uint8_t)combinedCount;
-            encoded.insert(encoded.begin(), sign);
-            return encoded;
-        } 
-        else 
+    size_t RlpEncoder::Write(const EncodableItem *item, uint8_t *buffer) const
+    {
+        if (item->IsList())
         {
-            std::vector<uint8_t> length = (encoded.size() | byte_array::size_to_bytes) | byte_array::truncate;
-
-            assert(length.size() < RLP_MAX_LENGTH);
-
-            const uint8_t sign = RLP_OFFSET_ARRAY_LONG + length.size();
-
-            for (int i = 0; i < length.size(); i++) 
+            assert(item->Bytes().size() == 0);
+            size_t position = writeHeader(buffer, PayloadSize(item), RLP_OFFSET_ARRAY_SHORT, RLP_OFFSET_ARRAY_LONG);
+            for (const EncodableItem &child : item->Children())
             {
-                encoded.insert(encoded.begin(), length[length.size() - i - 1]);
+                position += Write(&child, buffer + position);
             }
-            encoded.insert(encoded.begin(), sign);
-
-            return encoded;
+            return position;
         }
-    }
 
-    std::vector<uint8_t> RlpEncoder::EncodeBytes(const std::vector<uint8_t> *bytes) const
-    {
-        std::vector<uint8_t> encoded;
-        const size_t length = bytes->size();
-
-        if (length == 1 && (*bytes)[0] == 0x00)
+        assert(item->Children().size() == 0);
+        const ByteView bytes = item->Bytes();
+        if (isSingleByte(bytes))
         {
-            encoded.push_back(RLP_OFFSET_ITEM_SHORT);
+            buffer[0] = bytes[0];
+            return 1;
         }
-        else if (length == 1 && (*bytes)[0] < RLP_OFFSET_ITEM_SHORT)
+
+        const size_t length = PayloadSize(item);
+        const size_t header = writeHeader(buffer, length, RLP_OFFSET_ITEM_SHORT, RLP_OFFSET_ITEM_LONG);
+        if (length > 0)
         {
-            encoded.insert(encoded.end(), bytes->begin(), bytes->end());
+            memcpy(buffer + header, bytes.data(), length);
         }
-        else if (length <= RLP_LENGTH_THRESHOLD)
+        return header + length;
+    }
+
+    size_t RlpEncoder::ListHeaderSize(size_t payloadLength) const
+    {
+        return headerLength(payloadLength);
+    }
+
+    size_t RlpEncoder::WriteListHeader(size_t payloadLength, uint8_t *buffer) const
+    {
+        return writeHeader(buffer, payloadLength, RLP_OFFSET_ARRAY_SHORT, RLP_OFFSET_ARRAY_LONG);
+    }
+
+    size_t RlpEncoder::PayloadSize(const EncodableItem *item) const
+    {
+        if (!item->IsList())
         {
-            encoded.push_back((uint8_t)RLP_OFFSET_ITEM_SHORT + (uint8_t)length);
-            encoded.insert(encoded.end(), bytes->begin(), bytes->end());
+            const ByteView bytes = item->Bytes();
+            return bytes.size() == 1 && bytes[0] == 0x00 ? 0 : bytes.size();
         }
-        else
+
+        size_t length = 0;
+        for (const EncodableItem &child : item->Children())
         {
-            std::vector<uint8_t> header = generateHeader(length);
-            header = reverseHeader(header);
-            encoded.insert(encoded.end(), header.begin(), header.end());
-            encoded.insert(encoded.end(), bytes->begin(), bytes->end());
+            length += EncodedSize(&child);
         }
-
-        return encoded;
+        return length;
     }
-}
\ No newline at end of file
+}
@@ -44,9 +44,29 @@ namespace blockchain
         /// @return an RLP-encoded byte-array.
         std::vector<uint8_t> Encode(const EncodableItem *item) const override;
 
+        /// @brief Returns the exact number of bytes `Encode(item)` will produce.
+        /// @param item
+        /// @return
+        size_t EncodedSize(const EncodableItem *item) const;
+
+        /// @brief RLP-encodes `item` directly into `buffer`, front to back.
+        /// @param item
+        /// @param buffer Destination. Must be able to hold `EncodedSize(item)` bytes.
+        /// @return The number of bytes written.
+        size_t Write(const EncodableItem *item, uint8_t *buffer) const;
+
+        /// @brief Returns the size of the header of a list whose encoded items are `payloadLength` bytes.
+        size_t ListHeaderSize(size_t payloadLength) const;
+
+        /// @brief Writes the header of a list whose encoded items are `payloadLength` bytes (e.g. when the items are encoded separately).
+        /// @param payloadLength
+        /// @param buffer Destination. Must be able to hold `ListHeaderSize(payloadLength)` bytes.
+        /// @return The number of bytes written.
+        size_t WriteListHeader(size_t payloadLength, uint8_t *buffer) const;
+
     private:
-        std::vector<uint8_t> EncodeVector(const std::vector<EncodableItem> *items) const;
-        std::vector<uint8_t> EncodeBytes(const std::vector<uint8_t> *bytes) const;
+        /// @brief Returns the size of the encoded item excluding its header.
+        size_t PayloadSize(const EncodableItem *item) const;
     };
 }
 #endif
\ No newline at end of file
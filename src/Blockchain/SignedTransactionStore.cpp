@@ -0,0 +1,461 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2023 Tord Wessman
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+
+#include "SignedTransactionStore.h"
+#include "Signer.h"
+
+namespace blockchain
+{
+    // The log consists of one record per line:
+    //   "+ <from> <nonce> <raw transaction>" stores a transaction (replacing any with the same sender and nonce).
+    //   "- <hash>" removes a transaction.
+    // Values are hex encoded, except for the decimal nonce. An incomplete last line (e.g. after a crash) is ignored.
+
+    static bool isHex(const char *value)
+    {
+        size_t length = strlen(value);
+        if (length == 0 || length % 2 != 0)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < length; i++)
+        {
+            char c = value[i];
+            if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F')))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static void writeHex(FILE *file, const std::vector<uint8_t> &bytes)
+    {
+        const char *digits = "0123456789abcdef";
+        char buffer[128];
+        size_t position = 0;
+        for (uint8_t b : bytes)
+        {
+            buffer[position++] = digits[b >> 4];
+            buffer[position++] = digits[b & 0x0F];
+            if (position == sizeof(buffer))
+            {
+                fwrite(buffer, 1, position, file);
+                position = 0;
+            }
+        }
+        fwrite(buffer, 1, position, file);
+    }
+
+    static bool sameSender(const Address &a, const Address &b)
+    {
+        return strcasecmp(a.AsString(), b.AsString()) == 0;
+    }
+
+    /// @brief Returns `value` increased by `percent` percent, rounded up and by at least 1.
+    static BigNumber bump(const BigNumber &value, uint8_t percent)
+    {
+        BigNumber bumped = (value * BigNumber((uint32_t)(100 + percent)) + BigNumber(99u)) / BigNumber(100u);
+        return bumped > value ? bumped : value + BigNumber(1u);
+    }
+
+    SignedTransactionStore::~SignedTransactionStore()
+    {
+        if (log != nullptr)
+        {
+            fclose(log);
+        }
+        if (path != nullptr)
+        {
+            delete[] path;
+        }
+    }
+
+#ifndef ARDUINO
+    Result<size_t> SignedTransactionStore::Open(const char *path)
+    {
+        if (log != nullptr)
+        {
+            THROW("SignedTransactionStore::Open: the store is already backed by a log.");
+        }
+
+        std::vector<char> content;
+        FILE *file = fopen(path, "rb");
+        if (file != nullptr)
+        {
+            char buffer[1024];
+            size_t count;
+            while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+            {
+                content.insert(content.end(), buffer, buffer + count);
+            }
+            fclose(file);
+        }
+
+    #ifdef R2WEB3_THREADING_SUPPORTED
+        std::unique_lock<std::mutex> lock(mutex);
+    #endif
+        size_t lineStart = 0;
+        for (size_t i = 0; i < content.size(); i++)
+        {
+            if (content[i] != '\n')
+            {
+                continue;
+            }
+            content[i] = '\0';
+            char *line = content.data() + lineStart;
+            lineStart = i + 1;
+
+            char *context = nullptr;
+            char *operation = strtok_r(line, " ", &context);
+            if (operation == nullptr)
+            {
+                continue;
+            }
+            if (strcmp(operation, "+") == 0)
+            {
+                char *from = strtok_r(nullptr, " ", &context);
+                char *nonce = strtok_r(nullptr, " ", &context);
+                char *raw = strtok_r(nullptr, " ", &context);
+                if (from == nullptr || nonce == nullptr || raw == nullptr || 
+                    strlen(from) != ETH_ADDRESS_LENGTH || !isHex(from + 2) || !isHex(raw))
+                {
+                    return Result<size_t>::Err(TRANSACTION_STORE_ERROR, "Malformed record in transaction log.");
+                }
+                StoredTransaction transaction;
+                transaction.from = Address(from);
+                transaction.nonce = (uint32_t)strtoul(nonce, nullptr, 10);
+                transaction.raw = raw | byte_array::hex_string_to_bytes;
+                Insert(transaction, false);
+            }
+            else if (strcmp(operation, "-") == 0)
+            {
+                char *hash = strtok_r(nullptr, " ", &context);
+                if (hash == nullptr || !isHex(hash))
+                {
+                    return Result<size_t>::Err(TRANSACTION_STORE_ERROR, "Malformed record in transaction log.");
+                }
+                Erase(hash | byte_array::hex_string_to_bytes, false);
+            }
+            else
+            {
+                return Result<size_t>::Err(TRANSACTION_STORE_ERROR, "Malformed record in transaction log.");
+            }
+        }
+
+    #ifdef R2WEB3_THREADING_SUPPORTED
+        lock.unlock();
+    #endif
+
+        log = fopen(path, "ab");
+        if (log == nullptr)
+        {
+            return Result<size_t>::Err(TRANSACTION_STORE_ERROR, "Unable to open transaction log.");
+        }
+        this->path = path | char_string::copy;
+
+        if (lineStart < content.size())
+        {
+            // Drop the incomplete record so that new records start on a new line.
+            Result<size_t> compacted = Compact();
+            if (!compacted.HasValue())
+            {
+                // Appending after the incomplete record would corrupt the log for good.
+                fclose(log);
+                log = nullptr;
+                delete[] this->path;
+                this->path = nullptr;
+            }
+            return compacted;
+        }
+        return Size();
+    }
+
+    Result<size_t> SignedTransactionStore::Compact()
+    {
+    #ifdef R2WEB3_THREADING_SUPPORTED
+        std::lock_guard<std::mutex> lock(mutex);
+    #endif
+        if (log == nullptr)
+        {
+            THROW("SignedTransactionStore::Compact: the store is not backed by a log.");
+        }
+
+        // The compacted log is written next to the log and renamed, so that a crash leaves either of them intact.
+        std::vector<char> temporaryPath(path, path + strlen(path));
+        const char *suffix = ".tmp";
+        temporaryPath.insert(temporaryPath.end(), suffix, suffix + strlen(suffix) + 1);
+
+        FILE *file = fopen(temporaryPath.data(), "wb");
+        if (file == nullptr)
+        {
+            return Result<size_t>::Err(TRANSACTION_STORE_ERROR, "Unable to write transaction log.");
+        }
+        FILE *previous = log;
+        log = file;
+        for (const StoredTransaction &transaction : transactions)
+        {
+            LogAdd(transaction);
+        }
+        log = previous;
+        if (ferror(file) || rename(temporaryPath.data(), path) != 0)
+        {
+            fclose(file);
+            remove(temporaryPath.data());
+            return Result<size_t>::Err(TRANSACTION_STORE_ERROR, "Unable to replace transaction log.");
+        }
+
+        // The handle of the compacted log stays valid through the rename, so the previous log is only closed once it is in place.
+        fclose(previous);
+        log = file;
+        return transactions.size();
+    }
+#endif
+
+    std::vector<uint8_t> SignedTransactionStore::Add(const EthereumTransaction &transaction, const Address &from)
+    {
+        if (!transaction.Signature().IsSigned())
+        {
+            THROW("SignedTransactionStore::Add: the transaction is not signed.");
+        }
+        return Add(transaction.Serialize(), from, transaction.Properties().nonce);
+    }
+
+    std::vector<uint8_t> SignedTransactionStore::Add(const std::vector<uint8_t> &raw, const Address &from, uint32_t nonce)
+    {
+        StoredTransaction transaction;
+        transaction.from = from;
+        transaction.nonce = nonce;
+        transaction.raw = raw;
+    #ifdef R2WEB3_THREADING_SUPPORTED
+        std::lock_guard<std::mutex> lock(mutex);
+    #endif
+        return Insert(transaction, true);
+    }
+
+    bool SignedTransactionStore::Find(const std::vector<uint8_t> &hash, StoredTransaction &transaction) const
+    {
+    #ifdef R2WEB3_THREADING_SUPPORTED
+        std::lock_guard<std::mutex> lock(mutex);
+    #endif
+        for (const StoredTransaction &stored : transactions)
+        {
+            if (stored.hash == hash)
+            {
+                transaction = stored;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool SignedTransactionStore::Find(const Address &from, uint32_t nonce, StoredTransaction &transaction) const
+    {
+    #ifdef R2WEB3_THREADING_SUPPORTED
+        std::lock_guard<std::mutex> lock(mutex);
+    #endif
+        for (const StoredTransaction &stored : transactions)
+        {
+            if (stored.nonce == nonce && sameSender(stored.from, from))
+            {
+                transaction = stored;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool SignedTransactionStore::Remove(const std::vector<uint8_t> &hash)
+    {
+    #ifdef R2WEB3_THREADING_SUPPORTED
+        std::lock_guard<std::mutex> lock(mutex);
+    #endif
+        return Erase(hash, true);
+    }
+
+    size_t SignedTransactionStore::RemoveConfirmed(const Address &from, uint32_t transactionCount)
+    {
+    #ifdef R2WEB3_THREADING_SUPPORTED
+        std::lock_guard<std::mutex> lock(mutex);
+    #endif
+        size_t removed = 0;
+        for (size_t i = 0; i < transactions.size();)
+        {
+            if (transactions[i].nonce < transactionCount && sameSender(transactions[i].from, from))
+            {
+                LogRemove(transactions[i].hash);
+                transactions.erase(transactions.begin() + i);
+                removed++;
+            }
+            else
+            {
+                i++;
+            }
+        }
+        return removed;
+    }
+
+    std::vector<StoredTransaction> SignedTransactionStore::Pending() const
+    {
+    #ifdef R2WEB3_THREADING_SUPPORTED
+        std::lock_guard<std::mutex> lock(mutex);
+    #endif
+        return transactions;
+    }
+
+    std::vector<Address> SignedTransactionStore::Senders() const
+    {
+    #ifdef R2WEB3_THREADING_SUPPORTED
+        std::lock_guard<std::mutex> lock(mutex);
+    #endif
+        std::vector<Address> senders;
+        for (const StoredTransaction &transaction : transactions)
+        {
+            if (senders.empty() || !sameSender(senders.back(), transaction.from))
+            {
+                senders.push_back(transaction.from);
+            }
+        }
+        return senders;
+    }
+
+    size_t SignedTransactionStore::Size() const
+    {
+    #ifdef R2WEB3_THREADING_SUPPORTED
+        std::lock_guard<std::mutex> lock(mutex);
+    #endif
+        return transactions.size();
+    }
+
+    EthereumTransactionProperties SignedTransactionStore::SpeedUp(const EthereumTransactionProperties &properties, uint8_t bumpPercent)
+    {
+        switch (properties.signingStandard)
+        {
+        case EthereumSigningStandard::EIP1559:
+            return EthereumTransactionProperties::EIP1559(properties.nonce, bump(properties.maxPriorityFeePerGas, bumpPercent), 
+                                                          bump(properties.maxFeePerGas, bumpPercent), properties.gasLimit, properties.address, 
+                                                          properties.value, properties.data, properties.chainId, properties.accessList);
+        case EthereumSigningStandard::EIP2930:
+            return EthereumTransactionProperties::EIP2930(properties.nonce, bump(properties.gasPrice, bumpPercent), properties.gasLimit, 
+                                                          properties.address, properties.value, properties.data, properties.chainId, 
+                                                          properties.accessList);
+        default:
+            return EthereumTransactionProperties(properties.nonce, bump(properties.gasPrice, bumpPercent), properties.gasLimit, 
+                                                 properties.address, properties.value, properties.data, properties.chainId);
+        }
+    }
+
+    EthereumTransactionProperties SignedTransactionStore::Cancellation(const EthereumTransactionProperties &properties, const Address &from, 
+                                                                       uint8_t bumpPercent)
+    {
+        // A plain transfer always costs 21000 gas.
+        const uint32_t gasLimit = 21000;
+        if (properties.signingStandard == EthereumSigningStandard::EIP1559)
+        {
+            return EthereumTransactionProperties::EIP1559(properties.nonce, bump(properties.maxPriorityFeePerGas, bumpPercent), 
+                                                          bump(properties.maxFeePerGas, bumpPercent), gasLimit, from, 
+                                                          BigNumber(0u), std::vector<uint8_t>(), properties.chainId);
+        }
+        return EthereumTransactionProperties(properties.nonce, bump(properties.gasPrice, bumpPercent), gasLimit, 
+                                             from, BigNumber(0u), std::vector<uint8_t>(), properties.chainId);
+    }
+
+    std::vector<uint8_t> SignedTransactionStore::Insert(StoredTransaction transaction, bool record)
+    {
+        transaction.hash = Keccak256(&transaction.raw);
+
+        // Kept ordered by sender and nonce, so that the transactions of a sender are rebroadcasted in order.
+        size_t position = 0;
+        for (; position < transactions.size(); position++)
+        {
+            const StoredTransaction &stored = transactions[position];
+            int order = strcasecmp(stored.from.AsString(), transaction.from.AsString());
+            if (order > 0 || (order == 0 && stored.nonce >= transaction.nonce))
+            {
+                break;
+            }
+        }
+
+        if (record)
+        {
+            LogAdd(transaction);
+        }
+        if (position < transactions.size() && transactions[position].nonce == transaction.nonce && 
+            sameSender(transactions[position].from, transaction.from))
+        {
+            transactions[position] = transaction;
+        }
+        else
+        {
+            transactions.insert(transactions.begin() + position, transaction);
+        }
+        return transaction.hash;
+    }
+
+    bool SignedTransactionStore::Erase(const std::vector<uint8_t> &hash, bool record)
+    {
+        for (size_t i = 0; i < transactions.size(); i++)
+        {
+            if (transactions[i].hash == hash)
+            {
+                if (record)
+                {
+                    LogRemove(hash);
+                }
+                transactions.erase(transactions.begin() + i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void SignedTransactionStore::LogAdd(const StoredTransaction &transaction)
+    {
+        if (log == nullptr)
+        {
+            return;
+        }
+        fprintf(log, "+ %s %u ", transaction.from.AsString(), (unsigned int)transaction.nonce);
+        writeHex(log, transaction.raw);
+        fputc('\n', log);
+        fflush(log);
+    }
+
+    void SignedTransactionStore::LogRemove(const std::vector<uint8_t> &hash)
+    {
+        if (log == nullptr)
+        {
+            return;
+        }
+        fputs("- ", log);
+        writeHex(log, hash);
+        fputc('\n', log);
+        fflush(log);
+    }
+}
@@ -0,0 +1,142 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2023 Tord Wessman
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef __SIGNED_TRANSACTION_STORE_H__
+#define __SIGNED_TRANSACTION_STORE_H__
+
+#include <vector>
+#include <stdint.h>
+#include <cstdio>
+
+#include "../Shared/Common.h"
+#include "../Shared/BigNumber.h"
+#include "Address.h"
+#include "EthereumTransaction.h"
+
+#ifdef R2WEB3_THREADING_SUPPORTED
+#include <mutex>
+#endif
+
+namespace blockchain
+{
+    /// @brief Error code returned when the transaction log can't be read or written.
+    #define TRANSACTION_STORE_ERROR -55
+
+    /// @brief The minimum fee increase (in percent) nodes accept for a transaction replacing a pending one.
+    #define TRANSACTION_REPLACEMENT_BUMP_PERCENT 10
+
+    /// @brief A signed transaction as it was broadcasted.
+    struct StoredTransaction
+    {
+        /// @brief The 32-byte transaction hash.
+        std::vector<uint8_t> hash;
+        Address from;
+        uint32_t nonce;
+        /// @brief The serialized signed transaction (as sent by `eth_sendRawTransaction`).
+        std::vector<uint8_t> raw;
+    };
+
+    /// @brief Keeps the serialized signed transactions of pending transactions, so that they can be rebroadcasted
+    /// (see `Chain::Rebroadcast`) or replaced without re-signing. At most one transaction is stored per sender and nonce.
+    /// On desktop platforms the store can be backed by an append-only log, allowing a restarted process to resume.
+    class SignedTransactionStore
+    {
+    public:
+        SignedTransactionStore() : log(nullptr), path(nullptr) {}
+        ~SignedTransactionStore();
+
+        SignedTransactionStore(const SignedTransactionStore &) = delete;
+        SignedTransactionStore &operator=(const SignedTransactionStore &) = delete;
+
+    #ifndef ARDUINO
+        /// @brief Loads the transactions recorded in the log at `path` (created if missing). Subsequent changes are appended to the log.
+        /// @param path
+        /// @return The number of transactions loaded. A log ending in an incomplete record is compacted; if that fails, an error is 
+        /// returned and the store is left without a log.
+        Result<size_t> Open(const char *path);
+
+        /// @brief Rewrites the log so that it only contains the stored transactions.
+        /// @return The number of transactions written, or `TRANSACTION_STORE_ERROR` if the log can't be replaced (the previous log is then kept).
+        Result<size_t> Compact();
+    #endif
+
+        /// @brief Stores a signed transaction, replacing any transaction with the same sender and nonce.
+        /// @param transaction A signed transaction.
+        /// @param from The sender of `transaction`.
+        /// @return The transaction hash.
+        std::vector<uint8_t> Add(const EthereumTransaction &transaction, const Address &from);
+
+        /// @brief Stores a serialized signed transaction, replacing any transaction with the same sender and nonce.
+        /// @return The transaction hash.
+        std::vector<uint8_t> Add(const std::vector<uint8_t> &raw, const Address &from, uint32_t nonce);
+
+        /// @brief Copies the transaction with hash `hash` to `transaction`. Returns `false` if it isn't stored.
+        bool Find(const std::vector<uint8_t> &hash, StoredTransaction &transaction) const;
+
+        /// @brief Copies the transaction sent by `from` with nonce `nonce` to `transaction`. Returns `false` if it isn't stored.
+        bool Find(const Address &from, uint32_t nonce, StoredTransaction &transaction) const;
+
+        /// @brief Removes a transaction, e.g. after it has been confirmed. Returns `false` if it isn't stored.
+        bool Remove(const std::vector<uint8_t> &hash);
+
+        /// @brief Removes the transactions of `from` with a nonce lower than `transactionCount` (i.e. mined or replaced).
+        /// @param from
+        /// @param transactionCount The current transaction count of `from`.
+        /// @return The number of transactions removed.
+        size_t RemoveConfirmed(const Address &from, uint32_t transactionCount);
+
+        /// @brief Returns copies of the stored transactions ordered by sender and nonce.
+        std::vector<StoredTransaction> Pending() const;
+
+        /// @brief Returns the senders of the stored transactions.
+        std::vector<Address> Senders() const;
+
+        /// @brief Returns the number of stored transactions.
+        size_t Size() const;
+
+        /// @brief Returns a copy of `properties` with its fees raised by `bumpPercent` percent (at least 1 wei), 
+        /// to be signed and sent as a replacement of a pending transaction.
+        static EthereumTransactionProperties SpeedUp(const EthereumTransactionProperties &properties, 
+                                                     uint8_t bumpPercent = TRANSACTION_REPLACEMENT_BUMP_PERCENT);
+
+        /// @brief Returns a zero-value transfer from `from` to itself using the nonce of `properties` and fees raised by 
+        /// `bumpPercent` percent, to be signed and sent to cancel a pending transaction.
+        static EthereumTransactionProperties Cancellation(const EthereumTransactionProperties &properties, const Address &from,
+                                                          uint8_t bumpPercent = TRANSACTION_REPLACEMENT_BUMP_PERCENT);
+
+    private:
+        std::vector<StoredTransaction> transactions;
+        FILE *log;
+        char *path;
+    #ifdef R2WEB3_THREADING_SUPPORTED
+        mutable std::mutex mutex;
+    #endif
+        std::vector<uint8_t> Insert(StoredTransaction transaction, bool record);
+        bool Erase(const std::vector<uint8_t> &hash, bool record);
+        void LogAdd(const StoredTransaction &transaction);
+        void LogRemove(const std::vector<uint8_t> &hash);
+    };
+}
+#endif
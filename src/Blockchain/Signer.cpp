@@ -30,19 +30,14 @@ namespace blockchain
 {
     std::vector<uint8_t> Keccak256(const std::vector<uint8_t> *digest, const size_t length)
     {
-        uint8_t input[digest->size()];
-        uint8_t output[length];
+        return Keccak256(digest->data(), digest->size(), length);
+    }
 
-        for (int i = 0; i < digest->size(); i++)
-        {
-            input[i] = digest->at(i);
-        }
-        keccak_256(input, digest->size(), output);
-        std::vector<uint8_t> hash(length);
-        for (int i = 0; i < length; i++)
-        {
-            hash[i] = output[i];
-        }
-        return hash;
+    std::vector<uint8_t> Keccak256(const uint8_t *data, const size_t size, const size_t length)
+    {
+        // `keccak_256` always writes the full digest, even if fewer bytes are requested.
+        uint8_t output[KECCAK_256_LENGTH];
+        keccak_256(data, size, output);
+        return std::vector<uint8_t>(output, output + std::min(length, (size_t)KECCAK_256_LENGTH));
     }
 }
\ No newline at end of file
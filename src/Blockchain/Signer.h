@@ -39,6 +39,10 @@ namespace blockchain
         /// @return 
         std::vector<uint8_t> Keccak256(const std::vector<uint8_t> *digest, const size_t length = KECCAK_256_LENGTH);
 
+        /// @brief Generates a Keccek256 hash of `size` bytes starting at `data`.
+        /// @param length the size of the hash to return. Defaults to 32 bytes.
+        std::vector<uint8_t> Keccak256(const uint8_t *data, const size_t size, const size_t length = KECCAK_256_LENGTH);
+
         /// @brief Interface for signing transactions.
         /// @tparam TransactionType is the type of transaction objects this signer is capable to sign.
         template <typename TransactionType>
@@ -0,0 +1,228 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2023 Tord Wessman
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <functional>
+
+#include "TransactionBuilder.h"
+
+#ifdef R2WEB3_THREADING_SUPPORTED
+#include <thread>
+#endif
+
+namespace blockchain
+{
+    /// @brief Runs `tasks`, using one thread per task if `concurrent` is set.
+    static void run(const std::vector<std::function<void()>> &tasks, bool concurrent)
+    {
+    #ifdef R2WEB3_THREADING_SUPPORTED
+        if (concurrent && tasks.size() > 1)
+        {
+            std::vector<std::thread> threads;
+            for (size_t i = 1; i < tasks.size(); i++)
+            {
+                threads.push_back(std::thread(tasks[i]));
+            }
+            tasks[0]();
+            for (std::thread &thread : threads)
+            {
+                thread.join();
+            }
+            return;
+        }
+    #endif
+        for (const std::function<void()> &task : tasks)
+        {
+            task();
+        }
+    }
+
+    TransactionBuilder::TransactionBuilder(const Chain *chain) : chain(chain), estimateCache(nullptr), value(0u), gasPrice(0u), maxPriorityFeePerGas(0u), maxFeePerGas(0u),
+                                                                 nonce(0), gasLimit(0), chainId(0), signingStandard(EthereumSigningStandard::Legacy),
+                                                                 hasFrom(false), hasNonce(false), hasGasLimit(false), hasGasPrice(false), 
+                                                                 hasFeeCaps(false), hasSigningStandard(false) {}
+
+    TransactionBuilder &TransactionBuilder::From(const Address &from)
+    {
+        this->from = from;
+        hasFrom = true;
+        return *this;
+    }
+
+    TransactionBuilder &TransactionBuilder::To(const Address &to)
+    {
+        this->to = to;
+        return *this;
+    }
+
+    TransactionBuilder &TransactionBuilder::Value(const BigNumber &value)
+    {
+        this->value = value;
+        return *this;
+    }
+
+    TransactionBuilder &TransactionBuilder::Data(const std::vector<uint8_t> &data)
+    {
+        this->data = data;
+        return *this;
+    }
+
+    TransactionBuilder &TransactionBuilder::Call(const ContractCall &call)
+    {
+        return Data(call.AsData());
+    }
+
+    TransactionBuilder &TransactionBuilder::Nonce(uint32_t nonce)
+    {
+        this->nonce = nonce;
+        hasNonce = true;
+        return *this;
+    }
+
+    TransactionBuilder &TransactionBuilder::GasLimit(uint32_t gasLimit)
+    {
+        this->gasLimit = gasLimit;
+        hasGasLimit = true;
+        return *this;
+    }
+
+    TransactionBuilder &TransactionBuilder::GasPrice(const BigNumber &gasPrice)
+    {
+        this->gasPrice = gasPrice;
+        hasGasPrice = true;
+        return *this;
+    }
+
+    TransactionBuilder &TransactionBuilder::Fees(const BigNumber &maxPriorityFeePerGas, const BigNumber &maxFeePerGas)
+    {
+        this->maxPriorityFeePerGas = maxPriorityFeePerGas;
+        this->maxFeePerGas = maxFeePerGas;
+        hasFeeCaps = true;
+        return *this;
+    }
+
+    TransactionBuilder &TransactionBuilder::ChainId(uint32_t chainId)
+    {
+        this->chainId = chainId;
+        return *this;
+    }
+
+    TransactionBuilder &TransactionBuilder::AccessList(const std::vector<AccessListEntry> &accessList)
+    {
+        this->accessList = accessList;
+        return *this;
+    }
+
+    TransactionBuilder &TransactionBuilder::SigningStandard(EthereumSigningStandard signingStandard)
+    {
+        this->signingStandard = signingStandard;
+        hasSigningStandard = true;
+        return *this;
+    }
+
+    TransactionBuilder &TransactionBuilder::EstimateCache(GasEstimateCache *cache)
+    {
+        estimateCache = cache;
+        return *this;
+    }
+
+    Result<EthereumTransaction *> TransactionBuilder::Build() const
+    {
+        EthereumSigningStandard standard = signingStandard;
+        if (!hasSigningStandard)
+        {
+            standard = hasFeeCaps ? EthereumSigningStandard::EIP1559 : 
+                       !accessList.empty() ? EthereumSigningStandard::EIP2930 : EthereumSigningStandard::Legacy;
+        }
+
+        const bool needsFees = standard == EthereumSigningStandard::EIP1559 ? !hasFeeCaps : !hasGasPrice;
+        const uint32_t id = chainId != 0 ? chainId : (chain != nullptr ? chain->Id() : 0);
+
+        if (chain == nullptr && (!hasNonce || !hasGasLimit || needsFees || id == 0))
+        {
+            return Result<EthereumTransaction *>::Err(TRANSACTION_BUILDER_ERROR, "Nonce, gas limit, fees and chain id are required offline.");
+        }
+        if (!hasFrom && (!hasNonce || !hasGasLimit))
+        {
+            return Result<EthereumTransaction *>::Err(TRANSACTION_BUILDER_ERROR, "The sender is required to fetch the nonce and gas limit.");
+        }
+
+        // The chain id is loaded by `Chain::Start`, so at most three requests are needed. They are independent of each other.
+        Result<BigNumber> nonceResult = BigNumber(nonce);
+        Result<BigNumber> gasLimitResult = BigNumber(gasLimit);
+        Result<BigNumber> gasPriceResult = gasPrice;
+        FeeSuggestion feeCaps;
+        feeCaps.maxPriorityFeePerGas = maxPriorityFeePerGas;
+        feeCaps.maxFeePerGas = maxFeePerGas;
+        Result<FeeSuggestion> feesResult = feeCaps;
+
+        std::vector<std::function<void()>> requests;
+        if (!hasNonce)
+        {
+            requests.push_back([this, &nonceResult]() { nonceResult = chain->GetTransactionCount(from); });
+        }
+        if (!hasGasLimit)
+        {
+            requests.push_back([this, &gasLimitResult]() { gasLimitResult = chain->EstimateGas(from, to, value, data, estimateCache); });
+        }
+        if (needsFees && standard == EthereumSigningStandard::EIP1559)
+        {
+            requests.push_back([this, &feesResult]() { feesResult = chain->SuggestFees(); });
+        }
+        else if (needsFees)
+        {
+            requests.push_back([this, &gasPriceResult]() { gasPriceResult = chain->GetGasPrice(); });
+        }
+        run(requests, chain != nullptr && chain->IsThreadSafe());
+
+        if (!nonceResult.HasValue())
+        {
+            return Result<EthereumTransaction *>::Err(nonceResult);
+        }
+        if (!gasLimitResult.HasValue())
+        {
+            return Result<EthereumTransaction *>::Err(gasLimitResult);
+        }
+        if (!gasPriceResult.HasValue())
+        {
+            return Result<EthereumTransaction *>::Err(gasPriceResult);
+        }
+        if (!feesResult.HasValue())
+        {
+            return Result<EthereumTransaction *>::Err(feesResult);
+        }
+
+        const uint32_t n = nonceResult.Value().ToUInt32();
+        const uint32_t limit = gasLimitResult.Value().ToUInt32();
+        switch (standard)
+        {
+        case EthereumSigningStandard::EIP1559:
+            return new EthereumTransaction(EthereumTransactionProperties::EIP1559(n, feesResult.Value(), limit, to, value, data, id, accessList));
+        case EthereumSigningStandard::EIP2930:
+            return new EthereumTransaction(EthereumTransactionProperties::EIP2930(n, gasPriceResult.Value(), limit, to, value, data, id, accessList));
+        default:
+            return new EthereumTransaction(EthereumTransactionProperties(n, gasPriceResult.Value(), limit, to, value, data, id));
+        }
+    }
+}
@@ -0,0 +1,107 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2023 Tord Wessman
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef __TRANSACTION_BUILDER_H__
+#define __TRANSACTION_BUILDER_H__
+
+#include <vector>
+#include <stdint.h>
+
+#include "../Shared/Common.h"
+#include "../Shared/BigNumber.h"
+#include "Address.h"
+#include "Contract.h"
+#include "EthereumTransaction.h"
+#include "Chain.h"
+#include "GasEstimateCache.h"
+
+namespace blockchain
+{
+    /// @brief Error code returned when a transaction can't be built from the supplied fields.
+    #define TRANSACTION_BUILDER_ERROR -56
+
+    /// @brief Creates transactions ready to be signed. Fields that are not supplied (nonce, fees, gas limit and chain id) are
+    /// fetched from a `Chain`: all at once, using one thread per request if the network is thread safe. Without a `Chain`
+    /// (offline mode), all fields must be supplied.
+    class TransactionBuilder
+    {
+    public:
+        /// @brief Creates a builder for offline use.
+        TransactionBuilder() : TransactionBuilder(nullptr) {}
+
+        /// @brief Creates a builder fetching missing fields from `chain`.
+        /// @param chain A started chain or `nullptr` for offline mode.
+        explicit TransactionBuilder(const Chain *chain);
+
+        /// @brief The sender. Required to fetch the nonce and to estimate the gas limit.
+        TransactionBuilder &From(const Address &from);
+        TransactionBuilder &To(const Address &to);
+        TransactionBuilder &Value(const BigNumber &value);
+        TransactionBuilder &Data(const std::vector<uint8_t> &data);
+        /// @brief Uses the encoded `call` as data.
+        TransactionBuilder &Call(const ContractCall &call);
+        TransactionBuilder &Nonce(uint32_t nonce);
+        TransactionBuilder &GasLimit(uint32_t gasLimit);
+        /// @brief Sets the gas price of a legacy or EIP-2930 transaction. Implies a legacy transaction unless `AccessList` is used.
+        TransactionBuilder &GasPrice(const BigNumber &gasPrice);
+        /// @brief Sets the fees of an EIP-1559 transaction. Implies an EIP-1559 transaction.
+        TransactionBuilder &Fees(const BigNumber &maxPriorityFeePerGas, const BigNumber &maxFeePerGas);
+        TransactionBuilder &ChainId(uint32_t chainId);
+        /// @brief Sets the access list. Implies an EIP-2930 transaction unless an EIP-1559 transaction was requested.
+        TransactionBuilder &AccessList(const std::vector<AccessListEntry> &accessList);
+        /// @brief Sets the transaction type. Defaults to `EthereumSigningStandard::Legacy` unless implied by other fields.
+        TransactionBuilder &SigningStandard(EthereumSigningStandard signingStandard);
+
+        /// @brief Uses `cache` when the gas limit needs to be estimated (see `Chain::EstimateGas`).
+        TransactionBuilder &EstimateCache(GasEstimateCache *cache);
+
+        /// @brief Returns the unsigned transaction, fetching missing fields. Please note that the returned transaction needs to be deleted manually.
+        /// @return
+        Result<EthereumTransaction *> Build() const;
+
+    private:
+        const Chain *chain;
+        GasEstimateCache *estimateCache;
+        Address from;
+        Address to;
+        BigNumber value;
+        std::vector<uint8_t> data;
+        std::vector<AccessListEntry> accessList;
+        BigNumber gasPrice;
+        BigNumber maxPriorityFeePerGas;
+        BigNumber maxFeePerGas;
+        uint32_t nonce;
+        uint32_t gasLimit;
+        uint32_t chainId;
+        EthereumSigningStandard signingStandard;
+        bool hasFrom;
+        bool hasNonce;
+        bool hasGasLimit;
+        bool hasGasPrice;
+        bool hasFeeCaps;
+        bool hasSigningStandard;
+    };
+}
+#endif
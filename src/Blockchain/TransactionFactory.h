@@ -44,7 +44,7 @@ namespace blockchain
             = 0;
     #endif
 
-        virtual char* GenerateSerializedData(const TransactionProperties properties, const Account *account) const
+        virtual char* GenerateSerializedData(const TransactionProperties &properties, const Account *account) const
     #ifndef ARDUINO
         { THROW("<>::GenerateSerializedData must be overridden"); }
     #else
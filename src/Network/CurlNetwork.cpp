@@ -30,7 +30,7 @@
 
 namespace blockchain
 {
-    CurlNetwork::CurlNetwork(const bool printDebug) : printDebug(printDebug)
+    CurlNetwork::CurlNetwork(const bool printDebug) : printDebug(printDebug), curlHandleInUse(false)
     {
         curl_global_init(CURL_GLOBAL_DEFAULT);
         curlHandle = curl_easy_init();
@@ -42,6 +42,10 @@ namespace blockchain
         {
             curl_easy_cleanup(curlHandle);
         }
+        for (CURL *handle : idleHandles)
+        {
+            curl_easy_cleanup(handle);
+        }
         curl_global_cleanup();
     }
 
@@ -56,32 +60,42 @@ namespace blockchain
             return HttpResponse(-2);
         }
 
-        curl_easy_setopt(curlHandle, CURLOPT_URL, url);
-        curl_easy_setopt(curlHandle, CURLOPT_CUSTOMREQUEST, httpMethod);
-        curl_easy_setopt(curlHandle, CURLOPT_POSTFIELDS, body);
+        CURL *handle = AcquireHandle();
+        if (!handle)
+        {
+            THROW("Failed to initialize cURL.");
+            return HttpResponse(-2);
+        }
+
+        curl_easy_setopt(handle, CURLOPT_URL, url);
+        curl_easy_setopt(handle, CURLOPT_CUSTOMREQUEST, httpMethod);
+        curl_easy_setopt(handle, CURLOPT_POSTFIELDS, body);
         struct curl_slist *hs = NULL;
         hs = curl_slist_append(hs, "Content-Type: application/json");
-        curl_easy_setopt(curlHandle, CURLOPT_HTTPHEADER, hs);
+        curl_easy_setopt(handle, CURLOPT_HTTPHEADER, hs);
 
         std::string responseBuffer;
         char *response = nullptr;
 
-        curl_easy_setopt(curlHandle, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curlHandle, CURLOPT_WRITEDATA, &responseBuffer);
+        curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, WriteCallback);
+        curl_easy_setopt(handle, CURLOPT_WRITEDATA, &responseBuffer);
 
-        CURLcode res = curl_easy_perform(curlHandle);
+        CURLcode res = curl_easy_perform(handle);
         curl_slist_free_all(hs);
+
+        long httpCode = 0;
+        curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &httpCode);
+        ReleaseHandle(handle);
         
         if (res != CURLE_OK)
         {
             const char *error = curl_easy_strerror(res);
             response = new char[strlen(error) + 1];
+            memcpy(response, error, strlen(error));
             response[strlen(error)] = '\0';
             return HttpResponse(-1, response);
         }
 
-        long httpCode = 0;
-        curl_easy_getinfo(curlHandle, CURLINFO_RESPONSE_CODE, &httpCode);
         response = new char[responseBuffer.length() + 1];
         memcpy(response, responseBuffer.c_str(), responseBuffer.length());
         response[responseBuffer.length()] = '\0';
@@ -95,6 +109,36 @@ namespace blockchain
         return HttpResponse(httpCode, response);
     }
 
+    CURL *CurlNetwork::AcquireHandle() const
+    {
+        std::lock_guard<std::mutex> lock(handleMutex);
+        if (!curlHandleInUse)
+        {
+            curlHandleInUse = true;
+            return curlHandle;
+        }
+        if (!idleHandles.empty())
+        {
+            CURL *handle = idleHandles.back();
+            idleHandles.pop_back();
+            return handle;
+        }
+        return curl_easy_init();
+    }
+
+    void CurlNetwork::ReleaseHandle(CURL *handle) const
+    {
+        std::lock_guard<std::mutex> lock(handleMutex);
+        if (handle == curlHandle)
+        {
+            curlHandleInUse = false;
+        }
+        else
+        {
+            idleHandles.push_back(handle);
+        }
+    }
+
     size_t CurlNetwork::WriteCallback(void *contents, size_t size, size_t nmemb, std::string *output)
     {
         size_t totalSize = size * nmemb;
@@ -26,6 +26,8 @@
 #ifndef __CURL_NETWORK_H__
 #define __CURL_NETWORK_H__
 #include <curl/curl.h>
+#include <vector>
+#include <mutex>
 
 #include "NetworkFacade.h"
 #include "HttpResponse.h"
@@ -41,12 +43,22 @@ namespace blockchain
 
         HttpResponse MakeRequest(const char *url, const char *method, const char *body) const override;
 
+        /// @brief Concurrent requests use separate cURL handles.
+        bool IsThreadSafe() const override { return true; }
+
         CurlNetwork &operator=(const CurlNetwork &) = delete;
         CurlNetwork(const CurlNetwork &other) = delete;
 
     private:
         const bool printDebug;
         CURL *curlHandle;
+
+        // Additional handles created for concurrent requests, reused once idle.
+        mutable std::vector<CURL *> idleHandles;
+        mutable std::mutex handleMutex;
+        mutable bool curlHandleInUse;
+        CURL *AcquireHandle() const;
+        void ReleaseHandle(CURL *handle) const;
         static size_t WriteCallback(void *contents, size_t size, size_t nmemb, std::string *output);
     };
 }
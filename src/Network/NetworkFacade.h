@@ -49,6 +49,10 @@ namespace blockchain
     #else
             = 0;
     #endif
+
+        /// @brief Returns true if `MakeRequest` may be invoked concurrently from multiple threads.
+        /// @return
+        virtual bool IsThreadSafe() const { return false; }
     };
 }
 #endif
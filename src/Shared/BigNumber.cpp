@@ -22,300 +22,699 @@
  * SOFTWARE.
  */
 
-#include <sstream>
-#include <iomanip>
+#include <cstdio>
+#include <cctype>
+#include <strings.h>
 
 #include "BigNumber.h"
 #include "../Shared/Common.h"
 
 namespace blockchain
 {
-    char *intToChar(int number)
+    /// @brief Multiplies the words by `factor` and adds `addend`. Returns `false` if the result overflows.
+    bool multiplyAdd(uint16_t *words, const uint16_t factor, const uint16_t addend)
     {
-        int temp = number;
-        int length = 1;
-        while (temp /= 10)
+        uint32_t carry = addend;
+        for (size_t i = 0; i < BIG_NUMBER_MAX_WORDS; i++)
         {
-            length++;
+            carry += (uint32_t)words[i] * factor;
+            words[i] = carry & 0xFFFF;
+            carry >>= 16;
         }
+        return carry == 0;
+    }
 
-        char *str = new char[length + 1];
-        temp = number;
-        str[length] = '\0';
-        for (int i = length - 1; i >= 0; i--)
+    /// @brief Divides the words by `divisor` and returns the remainder.
+    uint16_t divide(uint16_t *words, const uint16_t divisor)
+    {
+        uint32_t remainder = 0;
+        for (size_t i = BIG_NUMBER_MAX_WORDS; i > 0; i--)
         {
-            str[i] = '0' + (temp % 10);
-            temp /= 10;
+            remainder = (remainder << 16) | words[i - 1];
+            words[i - 1] = remainder / divisor;
+            remainder %= divisor;
         }
-        return str;
+        return remainder;
     }
 
-    /// @brief remove any leading '0' characters. Warning! This method will delete []str.
-    /// @param str
-    /// @return
-    char *removeLeadingZeros(char *str)
+    /// @brief Returns the number of words required to represent the value (at least one).
+    uint8_t significantWords(const uint16_t *words)
     {
-        int i = 0;
-        while (str[i] == '0')
+        for (size_t i = BIG_NUMBER_MAX_WORDS; i > 1; i--)
         {
-            i++;
+            if (words[i - 1] != 0) { return i; }
         }
+        return 1;
+    }
 
-        if (i == 0)
+    /// @brief Compares the magnitudes. Returns -1, 0 or 1.
+    int compareWords(const uint16_t *lhs, const uint16_t *rhs)
+    {
+        for (size_t i = BIG_NUMBER_MAX_WORDS; i > 0; i--)
         {
-            return str;
+            if (lhs[i - 1] != rhs[i - 1]) { return lhs[i - 1] < rhs[i - 1] ? -1 : 1; }
         }
+        return 0;
+    }
 
-        size_t result_size = strlen(str) - i + 1;
+    /// @brief result = lhs + rhs. Returns `false` if the result overflows.
+    bool addWords(uint16_t *result, const uint16_t *lhs, const uint16_t *rhs)
+    {
+        uint32_t carry = 0;
+        for (size_t i = 0; i < BIG_NUMBER_MAX_WORDS; i++)
+        {
+            carry += (uint32_t)lhs[i] + rhs[i];
+            result[i] = carry & 0xFFFF;
+            carry >>= 16;
+        }
+        return carry == 0;
+    }
 
-        char *result = new char[result_size];
-        memcpy(result, str + i, result_size);
-        delete []str;
-        return result;
+    /// @brief result = lhs - rhs, where lhs >= rhs.
+    void subtractWords(uint16_t *result, const uint16_t *lhs, const uint16_t *rhs)
+    {
+        int32_t borrow = 0;
+        for (size_t i = 0; i < BIG_NUMBER_MAX_WORDS; i++)
+        {
+            int32_t difference = (int32_t)lhs[i] - rhs[i] - borrow;
+            borrow = difference < 0 ? 1 : 0;
+            result[i] = (uint16_t)(difference + (borrow << 16));
+        }
     }
 
-    /// @brief Treat the strings as numbers and add them. Return an allocated char * containing the sum. Result must be `free`d in order to avoid memory leaks.
-    /// @param lhs
-    /// @param rhs
-    /// @return
-    char *addStrings(const char *lhs, const char *rhs)
+    /// @brief result = lhs * rhs. Returns `false` if the result overflows.
+    bool multiplyWords(uint16_t *result, const uint16_t *lhs, const uint16_t *rhs)
     {
-        size_t lhsLength = strlen(lhs), rhsLength = strlen(rhs);
-        size_t length = std::max(lhsLength, rhsLength) + 1;
-        uint16_t result[length] = {};
+        uint16_t product[BIG_NUMBER_MAX_WORDS] = {};
+        for (size_t i = 0; i < BIG_NUMBER_MAX_WORDS; i++)
+        {
+            if (lhs[i] == 0) { continue; }
+            uint32_t carry = 0;
+            for (size_t j = 0; j < BIG_NUMBER_MAX_WORDS; j++)
+            {
+                if (i + j >= BIG_NUMBER_MAX_WORDS)
+                {
+                    if (rhs[j] != 0) { return false; }
+                    continue;
+                }
+                carry += (uint32_t)lhs[i] * rhs[j] + product[i + j];
+                product[i + j] = carry & 0xFFFF;
+                carry >>= 16;
+            }
+            if (carry != 0) { return false; }
+        }
+        memcpy(result, product, sizeof(product));
+        return true;
+    }
 
-        for (size_t i = 0; i < length; i++)
+    /// @brief Bitwise long division of the magnitudes.
+    void divideWords(uint16_t *quotient, uint16_t *remainder, const uint16_t *dividend, const uint16_t *divisor)
+    {
+        memset(quotient, 0, BIG_NUMBER_MAX_WORDS * sizeof(uint16_t));
+        memset(remainder, 0, BIG_NUMBER_MAX_WORDS * sizeof(uint16_t));
+        for (size_t bit = BIG_NUMBER_MAX_WORDS * 16; bit > 0; bit--)
         {
-            if (i < lhsLength)
+            // remainder = (remainder << 1) | next bit of the dividend.
+            for (size_t i = BIG_NUMBER_MAX_WORDS - 1; i > 0; i--)
             {
-                result[i] += lhs[lhsLength - i - 1] - '0';
+                remainder[i] = (remainder[i] << 1) | (remainder[i - 1] >> 15);
             }
-            if (i < rhsLength)
+            remainder[0] = (remainder[0] << 1) | ((dividend[(bit - 1) / 16] >> ((bit - 1) % 16)) & 1);
+
+            if (compareWords(remainder, divisor) >= 0)
             {
-                result[i] += rhs[rhsLength - i - 1] - '0';
+                subtractWords(remainder, remainder, divisor);
+                quotient[(bit - 1) / 16] |= 1 << ((bit - 1) % 16);
             }
         }
+    }
+
+    struct DecimalUnit
+    {
+        const char *name;
+        uint8_t decimals;
+    };
+
+    const DecimalUnit decimalUnits[] = {
+        {"wei", 0}, {"kwei", 3}, {"mwei", 6}, {"gwei", 9}, {"szabo", 12}, {"finney", 15}, {"ether", 18}
+    };
+
+    uint8_t hexCharToByte(const char c);
+
+    const char *hexDigits = "0123456789ABCDEF";
 
-        char *resultString = new char[length + 1];
-        resultString[length] = '\0';
+    BigNumber::BigNumber() : size(0), sign(Sign::Positive), hexString(nullptr)
+    {
+        memset(data, 0, sizeof(data));
+    }
+
+    BigNumber::BigNumber(uint32_t value) : size(value > 0xFFFF ? 2 : 1), sign(Sign::Positive), hexString(nullptr)
+    {
+        memset(data, 0, sizeof(data));
+        data[0] = value & 0xFFFF;
+        data[1] = value >> 16;
+    }
+
+#if __cplusplus >= 201402L
+    BigNumber::BigNumber(const BigNumberConstant &constant) : sign(Sign::Positive), hexString(nullptr)
+    {
+        memcpy(data, constant.words, sizeof(data));
+        size = significantWords(data);
+    }
+
+#endif
+    BigNumber::BigNumber(const std::vector<uint16_t> value) : sign(Sign::Positive), hexString(nullptr)
+    {
+        SetWords(value.data(), value.size());
+    }
 
-        for (size_t i = 0; i < length - 1; i++)
+    BigNumber::BigNumber(const char *hexString) : sign(Sign::Positive), hexString(nullptr)
+    {
+        size_t length = strlen(hexString);
+        string_info str(hexString, length);
+        string_info hexLetters = (str | char_string::remove_hex_prefix);
+        const size_t wordLength = sizeof(uint16_t) * 2;
+        const char *letters = hexLetters.value + hexLetters.begin;
+        size_t letterCount = hexLetters.length;
+
+        // Ignore leading zeros that would not fit in the available words.
+        while (letterCount > BIG_NUMBER_MAX_WORDS * wordLength && *letters == '0')
         {
-            result[i + 1] += result[i] / 10;
-            result[i] = result[i] % 10;
+            letters++;
+            letterCount--;
         }
 
-        for (size_t i = 0; i < length; i++)
+        if (letterCount > BIG_NUMBER_MAX_WORDS * wordLength)
         {
-            resultString[i] = result[length - i - 1] + '0';
+            THROW("Unable to parse hex string. Value exceeds 256 bits.");
         }
 
-        return removeLeadingZeros(resultString);
+        memset(data, 0, sizeof(data));
+        size = (letterCount + wordLength - 1) / wordLength;
+
+        for (size_t i = 0; i < letterCount; i++)
+        {
+            const size_t nibble = letterCount - i - 1;
+            data[nibble / wordLength] |= (uint16_t)hexCharToByte(letters[i]) << ((nibble % wordLength) * 4);
+        }
     }
 
-    /// @brief Treat the strings as numbers and multipy them. Return an allocated char * containing the product. Result must be `free`d in order to avoid memory leaks.
-    /// @param lhs
-    /// @param rhs
-    /// @return
-    char *multiplyStrings(const char *lhs, const char *rhs)
+    BigNumber::BigNumber(float toGwei, uint8_t decimals = 18) : size(0), sign(Sign::Positive), hexString(nullptr)
     {
-        size_t alength = strlen(lhs);
-        size_t blength = strlen(rhs);
-        size_t length = alength + blength + 1;
+        // A float carries roughly 7 significant digits, so anything beyond 6 decimals is noise.
+        char decimalString[48];
+        snprintf(decimalString, sizeof(decimalString), "%.*f", decimals < 6 ? decimals : 6, toGwei);
+        *this = BigNumber::ParseDecimal(decimalString, decimals).Value();
+    }
+
+    Result<BigNumber> BigNumber::ParseDecimal(const char *value, uint8_t decimals)
+    {
+        if (value == nullptr)
+        {
+            return Result<BigNumber>::Err(BIG_NUMBER_PARSE_ERROR, "Missing decimal string.");
+        }
+
+        const char *begin = value;
+        while (isspace(*begin)) { begin++; }
+
+        Sign sign = Sign::Positive;
+        if (*begin == '-' || *begin == '+')
+        {
+            sign = *begin == '-' ? Sign::Negative : Sign::Positive;
+            begin++;
+        }
 
-        uint result[length] = {};
+        // Locate the end of the number and the optional unit suffix.
+        const char *end = begin;
+        while (isdigit(*end) || *end == '.') { end++; }
 
-        uint16_t a, b, i, val, digit;
-        for (size_t ia = 0; ia < alength; ia++)
+        const char *unit = end;
+        while (isspace(*unit)) { unit++; }
+        const char *unitEnd = unit;
+        while (isalpha(*unitEnd)) { unitEnd++; }
+        const char *trailing = unitEnd;
+        while (isspace(*trailing)) { trailing++; }
+
+        if (*trailing != '\0')
         {
-            a = lhs[alength - ia - 1] - '0';
-            for (size_t ib = 0; ib < blength; ib++)
+            return Result<BigNumber>::Err(BIG_NUMBER_PARSE_ERROR, "Invalid character in decimal string.");
+        }
+
+        if (unit != unitEnd)
+        {
+            bool found = false;
+            for (const DecimalUnit &decimalUnit : decimalUnits)
+            {
+                if (strlen(decimalUnit.name) == (size_t)(unitEnd - unit) && strncasecmp(decimalUnit.name, unit, unitEnd - unit) == 0)
+                {
+                    decimals = decimalUnit.decimals;
+                    found = true;
+                    break;
+                }
+            }
+            if (!found)
             {
-                b = rhs[blength - ib - 1] - '0';
-                i = ia + ib;
-                val = a * b;
-                digit = val % 10;
-                result[i] += digit;
-                result[i + 1] += val / 10;
+                return Result<BigNumber>::Err(BIG_NUMBER_PARSE_ERROR, "Unknown unit in decimal string.");
             }
         }
 
-        char *resultString = new char[length + 1];
-        resultString[length] = '\0';
+        uint16_t words[BIG_NUMBER_MAX_WORDS] = {};
+        bool hasDigits = false;
+        bool fraction = false;
+        size_t fractionDigits = 0;
+        uint16_t chunk = 0, chunkFactor = 1;
 
-        for (size_t i = 0; i < length - 1; i++)
+        for (const char *c = begin; c < end; c++)
         {
-            result[i + 1] += result[i] / 10;
-            result[i] = result[i] % 10;
+            if (*c == '.')
+            {
+                if (fraction)
+                {
+                    return Result<BigNumber>::Err(BIG_NUMBER_PARSE_ERROR, "Multiple decimal points in decimal string.");
+                }
+                fraction = true;
+                continue;
+            }
+
+            hasDigits = true;
+            if (fraction && ++fractionDigits > decimals)
+            {
+                // Excess fraction digits are only accepted if they don't affect the value.
+                if (*c != '0')
+                {
+                    return Result<BigNumber>::Err(BIG_NUMBER_PARSE_ERROR, "Decimal string has more decimals than allowed.");
+                }
+                continue;
+            }
+
+            // Accumulate 4 digits at a time (10^4 fits in a word).
+            chunk = chunk * 10 + (*c - '0');
+            chunkFactor *= 10;
+            if (chunkFactor == 10000)
+            {
+                if (!multiplyAdd(words, chunkFactor, chunk))
+                {
+                    return Result<BigNumber>::Err(BIG_NUMBER_PARSE_ERROR, "Decimal value exceeds 256 bits.");
+                }
+                chunk = 0; chunkFactor = 1;
+            }
         }
 
-        for (size_t i = 0; i < length; i++)
+        if (!hasDigits)
         {
-            resultString[i] = result[length - i - 1] + '0';
+            return Result<BigNumber>::Err(BIG_NUMBER_PARSE_ERROR, "No digits in decimal string.");
         }
 
-        return removeLeadingZeros(resultString);
+        // Scale the remaining decimals.
+        for (size_t i = fractionDigits; i < decimals; i++)
+        {
+            chunk *= 10;
+            chunkFactor *= 10;
+            if (chunkFactor == 10000)
+            {
+                if (!multiplyAdd(words, chunkFactor, chunk))
+                {
+                    return Result<BigNumber>::Err(BIG_NUMBER_PARSE_ERROR, "Decimal value exceeds 256 bits.");
+                }
+                chunk = 0; chunkFactor = 1;
+            }
+        }
+
+        if (chunkFactor > 1 && !multiplyAdd(words, chunkFactor, chunk))
+        {
+            return Result<BigNumber>::Err(BIG_NUMBER_PARSE_ERROR, "Decimal value exceeds 256 bits.");
+        }
+
+        return Result<BigNumber>(FromWords(words, sign));
     }
 
-    BigNumber::BigNumber()
+    BigNumber::BigNumber(const BigNumber *other) : size(0), sign(Sign::Positive), hexString(nullptr)
     {
-        hexString = new char[1];
-        hexString[0] = '\0';
+        memset(data, 0, sizeof(data));
+        if (other != nullptr)
+        {
+            memcpy(data, other->data, sizeof(data));
+            size = other->size;
+            sign = other->sign;
+        }
     }
 
-    BigNumber::BigNumber(uint32_t value)
+    void BigNumber::SetWords(const uint16_t *words, size_t count)
     {
-        data.insert(data.begin(), value & 0xFFFF);
-        if (value > 0xFFFF)
+        // Ignore leading zero-words that would not fit.
+        while (count > BIG_NUMBER_MAX_WORDS && *words == 0)
+        {
+            words++;
+            count--;
+        }
+
+        if (count > BIG_NUMBER_MAX_WORDS)
+        {
+            THROW("Value exceeds 256 bits.");
+        }
+
+        memset(data, 0, sizeof(data));
+        size = count;
+        for (size_t i = 0; i < count; i++)
         {
-            data.insert(data.begin(), (value >> 16));
+            data[i] = words[count - i - 1];
         }
-        GenerateHexString();
     }
 
-    BigNumber::BigNumber(const std::vector<uint16_t> value)
+    char *BigNumber::ReleaseHexString()
     {
-        data = value;
-        GenerateHexString();
+        char *released = hexString;
+        hexString = nullptr;
+        return released;
     }
 
-    BigNumber::BigNumber(const char *hexString)
+    char *BigNumber::HexString() const
     {
-        size_t length = strlen(hexString);
-        string_info str(hexString, length);
-        string_info hexLetters = (str | char_string::remove_hex_prefix);
-        uint16_t byteValue;
-        size_t dataTypeLength = sizeof(byteValue) * 2;
-
-        size_t i = hexLetters.length;
-        size_t len;
-        char tmp[dataTypeLength + 1];
-        while (i > 0)
-        {
-            memset(tmp, 0, dataTypeLength + 1);
-            len = (size_t)std::min(i, dataTypeLength);
-            memcpy(tmp, hexLetters.value + hexLetters.begin + i - len, len);
-            byteValue = strtol(tmp, nullptr, 16);
-            data.insert(data.begin(), byteValue);
-            if (i - len < 0)
-            {
-                i = 0;
-            }
-            else
-            {
-                i -= len;
-            }
+        char *cached = hexString;
+        if (cached != nullptr)
+        {
+            return cached;
+        }
+
+        char *generated = new char[HexStringLength() + 1];
+        WriteHexString(generated, HexStringLength() + 1);
+#ifdef R2WEB3_THREADING_SUPPORTED
+        // Another thread might have generated the string in the meantime. If so, use that one instead.
+        if (!hexString.compare_exchange_strong(cached, generated))
+        {
+            delete[] generated;
+            return cached;
         }
-        GenerateHexString();
+#else
+        hexString = generated;
+#endif
+        return generated;
     }
 
-    BigNumber::BigNumber(float toGwei, uint8_t decimals = 18)
+    size_t BigNumber::WriteHexString(char *buffer, size_t length) const
     {
-        THROW("Not implemented yet.");
-        GenerateHexString();
+        const size_t stringLength = HexStringLength();
+        if (length < stringLength + 1)
+        {
+            return 0;
+        }
+
+        size_t position = 0;
+        if (sign == Sign::Negative)
+        {
+            buffer[position++] = '-';
+        }
+
+        for (size_t nibble = size * 4; nibble > 0; nibble--)
+        {
+            buffer[position++] = hexDigits[(data[(nibble - 1) / 4] >> (((nibble - 1) % 4) * 4)) & 0xF];
+        }
+        buffer[stringLength] = '\0';
+        return stringLength;
     }
 
-    BigNumber::BigNumber(const BigNumber *other)
+    char *BigNumber::GenerateDecimalString() const
     {
-        if (other != nullptr)
+        // 2^256 has 78 decimal digits.
+        char digits[80];
+        size_t length = 0;
+        uint16_t words[BIG_NUMBER_MAX_WORDS];
+        memcpy(words, data, sizeof(words));
+
+        // Extract 4 digits at a time, least significant first.
+        do
         {
-            for (uint16_t part: other->data) 
+            uint16_t remainder = divide(words, 10000);
+            for (size_t i = 0; i < 4; i++)
             {
-                data.push_back(part);
+                digits[length++] = '0' + remainder % 10;
+                remainder /= 10;
             }
+        } while (significantWords(words) > 1 || words[0] != 0);
+
+        while (length > 1 && digits[length - 1] == '0') { length--; }
+
+        if (sign == Sign::Negative)
+        {
+            digits[length++] = '-';
+        }
+
+        char *decimalString = new char[length + 1];
+        for (size_t i = 0; i < length; i++)
+        {
+            decimalString[i] = digits[length - i - 1];
         }
-        GenerateHexString();
+        decimalString[length] = '\0';
+        return decimalString;
     }
 
-    void BigNumber::GenerateHexString()
+    std::vector<uint8_t> BigNumber::Bytes() const
     {
-        const char *hexStringFormat = "%04X";
-        size_t length = 2 * data.size() * sizeof(uint16_t) + 1;
-        hexString = new char[length];
-        hexString[length - 1] = '\0';
-        for (int i = 0; i < data.size(); i++)
+        std::vector<uint8_t> result(size * sizeof(uint16_t));
+
+        for (size_t i = 0; i < size; i++)
         {
-            std::snprintf(hexString + i * 2 * sizeof(uint16_t), 2 * sizeof(uint16_t) + 1, hexStringFormat, data[i]);
+            result[2 * i] = static_cast<uint8_t>(data[size - i - 1] >> 8);
+            result[2 * i + 1] = static_cast<uint8_t>(data[size - i - 1] & 0xFF);
         }
+        return result;
     }
 
-    char *BigNumber::GenerateDecimalString() const
+    uint32_t BigNumber::ToUInt32() const
     {
-        char *decimalString = new char[2];
-        decimalString[0] = '0';
-        decimalString[1] = '\0';
-        if (data.size() == 0)
+        if (size > 2)
         {
-            return decimalString;
+            THROW("Can't convert decimal string to int. Number is too large.");
         }
+        return ((uint32_t)data[1] << 16) | data[0];
+    }
 
-        const char *factor = "65536";
+    BigNumber BigNumber::FromWords(const uint16_t *words, Sign sign)
+    {
+        BigNumber number;
+        memcpy(number.data, words, sizeof(number.data));
+        number.size = significantWords(words);
+        number.sign = number.IsZero() ? Sign::Positive : sign;
+        return number;
+    }
 
-        char *tmpNumber;
-        char *tmpProduct;
+    bool BigNumber::IsZero() const
+    {
+        for (size_t i = 0; i < BIG_NUMBER_MAX_WORDS; i++)
+        {
+            if (data[i] != 0) { return false; }
+        }
+        return true;
+    }
 
-        for (size_t i = 0; i < data.size(); i++)
+    int BigNumber::Compare(const BigNumber &other) const
+    {
+        if (sign != other.sign)
         {
-            tmpNumber = intToChar((int)data[i]);
+            return sign == Sign::Negative ? -1 : 1;
+        }
+        const int magnitude = compareWords(data, other.data);
+        return sign == Sign::Negative ? -magnitude : magnitude;
+    }
 
-            for (size_t j = 0; j < data.size() - i - 1; j++)
-            {
-                tmpProduct = multiplyStrings(tmpNumber, factor);
+    BigNumber BigNumber::operator-() const
+    {
+        return FromWords(data, sign == Sign::Negative ? Sign::Positive : Sign::Negative);
+    }
 
-                delete[] tmpNumber;
-                tmpNumber = new char[strlen(tmpProduct) + 1];
-                memcpy(tmpNumber, tmpProduct, strlen(tmpProduct) + 1);
-                delete[] tmpProduct;
+    BigNumber BigNumber::operator+(const BigNumber &other) const
+    {
+        uint16_t result[BIG_NUMBER_MAX_WORDS];
+        if (sign == other.sign)
+        {
+            if (!addWords(result, data, other.data))
+            {
+                THROW("BigNumber overflow.");
             }
+            return FromWords(result, sign);
+        }
 
-            tmpProduct = addStrings(decimalString, tmpNumber);
-            delete[] tmpNumber;
-            delete[] decimalString;
-            decimalString = new char[strlen(tmpProduct) + 1];
-            memcpy(decimalString, tmpProduct, strlen(tmpProduct) + 1);
-            delete[] tmpProduct;
+        // Different signs: subtract the smaller magnitude from the larger one.
+        if (compareWords(data, other.data) >= 0)
+        {
+            subtractWords(result, data, other.data);
+            return FromWords(result, sign);
         }
-        return decimalString;
+        subtractWords(result, other.data, data);
+        return FromWords(result, other.sign);
     }
 
-    std::vector<uint8_t> BigNumber::Bytes() const
+    BigNumber BigNumber::operator-(const BigNumber &other) const
     {
-        std::vector<uint8_t> result;
+        return *this + (-other);
+    }
 
-        const size_t epe = sizeof(uint16_t) / sizeof(uint8_t);
-        uint16_t value;
-        size_t digitCount;
-        for (int i = 0; i < data.size(); i++)
+    BigNumber BigNumber::operator*(const BigNumber &other) const
+    {
+        uint16_t result[BIG_NUMBER_MAX_WORDS];
+        if (!multiplyWords(result, data, other.data))
         {
-            value = data[i];
-            digitCount = 0;
-            std::vector<uint8_t> word;
-            for (size_t j = 0; j < epe; j++)
+            THROW("BigNumber overflow.");
+        }
+        return FromWords(result, sign == other.sign ? Sign::Positive : Sign::Negative);
+    }
+
+    BigNumber BigNumber::operator/(const BigNumber &other) const
+    {
+        if (other.IsZero())
+        {
+            THROW("BigNumber division by zero.");
+        }
+        uint16_t quotient[BIG_NUMBER_MAX_WORDS], remainder[BIG_NUMBER_MAX_WORDS];
+        divideWords(quotient, remainder, data, other.data);
+        return FromWords(quotient, sign == other.sign ? Sign::Positive : Sign::Negative);
+    }
+
+    BigNumber BigNumber::operator%(const BigNumber &other) const
+    {
+        if (other.IsZero())
+        {
+            THROW("BigNumber division by zero.");
+        }
+        uint16_t quotient[BIG_NUMBER_MAX_WORDS], remainder[BIG_NUMBER_MAX_WORDS];
+        divideWords(quotient, remainder, data, other.data);
+        return FromWords(remainder, sign);
+    }
+
+    bool BigNumber::FitsInBits(uint16_t bits, bool isSigned) const
+    {
+        if (!isSigned)
+        {
+            if (sign == Sign::Negative) { return false; }
+            for (size_t bit = bits; bit < BIG_NUMBER_MAX_WORDS * 16; bit++)
             {
-                word.insert(word.begin(), static_cast<uint8_t>(value & 0xFF));
-                value >>= 8;
+                if ((data[bit / 16] >> (bit % 16)) & 1) { return false; }
             }
-            for (uint8_t digit : word)
+            return true;
+        }
+
+        if (bits == 0) { return false; }
+
+        // Signed range is [-2^(bits-1), 2^(bits-1) - 1]. A negative value's magnitude may be exactly 2^(bits-1).
+        uint16_t magnitude[BIG_NUMBER_MAX_WORDS];
+        memcpy(magnitude, data, sizeof(magnitude));
+        if (sign == Sign::Negative)
+        {
+            const uint16_t one[BIG_NUMBER_MAX_WORDS] = {1};
+            subtractWords(magnitude, magnitude, one);
+        }
+        for (size_t bit = bits - 1; bit < BIG_NUMBER_MAX_WORDS * 16; bit++)
+        {
+            if ((magnitude[bit / 16] >> (bit % 16)) & 1) { return false; }
+        }
+        return true;
+    }
+
+    void BigNumber::WriteBigEndian(uint8_t (&out)[32]) const
+    {
+        for (size_t i = 0; i < BIG_NUMBER_MAX_WORDS; i++)
+        {
+            out[31 - 2 * i] = (uint8_t)(data[i] & 0xFF);
+            out[30 - 2 * i] = (uint8_t)(data[i] >> 8);
+        }
+    }
+
+    void BigNumber::WriteTwosComplement(uint8_t (&out)[32]) const
+    {
+        WriteBigEndian(out);
+        if (sign == Sign::Negative)
+        {
+            // Two's complement: invert and add one.
+            uint16_t carry = 1;
+            for (size_t i = 32; i > 0; i--)
             {
-                result.push_back(digit);
+                carry += (uint8_t)~out[i - 1];
+                out[i - 1] = carry & 0xFF;
+                carry >>= 8;
             }
         }
-        return result;
     }
 
-    uint32_t BigNumber::ToUInt32() const
+    size_t BigNumber::MinimalByteLength() const
     {
-        if (data.size() > 2)
+        for (size_t i = BIG_NUMBER_MAX_WORDS; i > 0; i--)
         {
-            THROW("Can't convert decimal string to int. Number is too large.");
+            if (data[i - 1] != 0) { return 2 * i - (data[i - 1] > 0xFF ? 0 : 1); }
         }
-        if (data.size() == 0)
+        return 0;
+    }
+
+    size_t BigNumber::WriteMinimal(uint8_t *buffer, size_t length) const
+    {
+        const size_t byteLength = MinimalByteLength();
+        if (length < byteLength)
         {
             return 0;
         }
-        char *decimalString = GenerateDecimalString();
-        uint32_t value = strtol(decimalString, nullptr, 10);
-        delete[] decimalString;
-        return value;
+        for (size_t i = 0; i < byteLength; i++)
+        {
+            buffer[byteLength - i - 1] = (uint8_t)(data[i / 2] >> ((i % 2) * 8));
+        }
+        return byteLength;
+    }
+
+    std::vector<uint8_t> BigNumber::TwosComplementBytes(size_t length) const
+    {
+        uint8_t word[32];
+        WriteTwosComplement(word);
+
+        std::vector<uint8_t> result(length, sign == Sign::Negative ? 0xFF : 0x00);
+        for (size_t i = 0; i < length && i < sizeof(word); i++)
+        {
+            result[length - i - 1] = word[sizeof(word) - i - 1];
+        }
+        return result;
+    }
+
+    BigNumber BigNumber::FromBigEndian(const uint8_t *bytes, size_t length)
+    {
+        while (length > BIG_NUMBER_MAX_WORDS * 2 && *bytes == 0)
+        {
+            bytes++;
+            length--;
+        }
+
+        if (length > BIG_NUMBER_MAX_WORDS * 2)
+        {
+            THROW("Value exceeds 256 bits.");
+        }
+
+        uint16_t words[BIG_NUMBER_MAX_WORDS] = {};
+        for (size_t i = 0; i < length; i++)
+        {
+            words[i / 2] |= (uint16_t)bytes[length - i - 1] << ((i % 2) * 8);
+        }
+        return FromWords(words, Sign::Positive);
+    }
+
+    BigNumber BigNumber::FromTwosComplement(const uint8_t *bytes, size_t length)
+    {
+        if (length > BIG_NUMBER_MAX_WORDS * 2)
+        {
+            THROW("Two's complement value exceeds 256 bits.");
+        }
+
+        const bool negative = length > 0 && (bytes[0] & 0x80);
+        uint16_t words[BIG_NUMBER_MAX_WORDS];
+        memset(words, negative ? 0xFF : 0x00, sizeof(words));
+        for (size_t i = 0; i < length; i++)
+        {
+            uint16_t &word = words[i / 2];
+            const size_t shift = (i % 2) * 8;
+            word = (word & ~(0xFF << shift)) | ((uint16_t)bytes[length - i - 1] << shift);
+        }
+
+        if (negative)
+        {
+            const uint16_t one[BIG_NUMBER_MAX_WORDS] = {1};
+            for (size_t i = 0; i < BIG_NUMBER_MAX_WORDS; i++) { words[i] = ~words[i]; }
+            addWords(words, words, one);
+        }
+        return FromWords(words, negative ? Sign::Negative : Sign::Positive);
     }
 }
\ No newline at end of file
@@ -29,17 +29,27 @@
 #include <stdint.h>
 #include <cstring>
 
+#include "Common.h"
+#include "BigNumberConstant.h"
+
+#ifdef R2WEB3_THREADING_SUPPORTED
+#include <atomic>
+#endif
+
 namespace blockchain
 {
-    /// @brief Represents a "large" real number.
+    /// @brief Error code returned when a string can't be parsed into a `BigNumber`.
+    #define BIG_NUMBER_PARSE_ERROR -50
+
+    /// @brief Represents a "large" real number: a sign and a magnitude of up to 256 bits.
     class BigNumber
     {
+    public:
         enum Sign {
             Positive,
             Negative
         };
 
-    public:
         /// @brief Represents '0'
         BigNumber();
 
@@ -51,63 +61,164 @@ namespace blockchain
         /// @param value
         BigNumber(uint32_t value);
 
+#if __cplusplus >= 201402L
+        /// @brief Constructor using a compile-time constant (e.g. `BigNumber(30_gwei)`). Does not allocate.
+        /// @param constant
+        BigNumber(const BigNumberConstant &constant);
+
+#endif
         /// @brief Construct using an array of 16-bit values.
         /// @param value
         BigNumber(const std::vector<uint16_t> value);
 
-        /// @brief A floating point representation of a value, which will transform it to it's gwei-representation
+        /// @brief A floating point representation of a value, which will transform it to it's gwei-representation.
+        /// The value is rounded to 6 decimals. Use `ParseDecimal` for exact values.
         /// @param toGwei The value in whole units.
         /// @param decimals The number of decimals to use.
         BigNumber(float toGwei, uint8_t decimals);
 
+        /// @brief Parses a decimal string into its smallest-unit representation without using floating point arithmetic.
+        /// The string may start with a sign ('-' or '+') and have a unit suffix ("wei", "kwei", "mwei", "gwei", "szabo", "finney" or "ether"),
+        /// e.g. `ParseDecimal("1.5 ether")` or `ParseDecimal("30 gwei")`. For token amounts, pass the token decimals instead:
+        /// `ParseDecimal("12.5", 6)`.
+        /// @param value The decimal string.
+        /// @param decimals Number of decimals of the unit. Ignored if `value` has a unit suffix.
+        /// @return The parsed value or `BIG_NUMBER_PARSE_ERROR` if the string is malformed, has more decimals than
+        /// `decimals` or exceeds 256 bits.
+        static Result<BigNumber> ParseDecimal(const char *value, uint8_t decimals = 0);
+
         /// @brief Copy reference.
         /// @param other 
         BigNumber(const BigNumber *other);
 
-        BigNumber(const BigNumber &other)
+        /// @brief Copies the value. The hex-string representation is not copied, but regenerated on demand.
+        BigNumber(const BigNumber &other) : size(other.size), sign(other.sign), hexString(nullptr)
         {
-            if (other.hexString != nullptr)
-            {
-                hexString = new char[strlen(other.hexString) + 1];
-                memcpy(hexString, other.hexString, strlen(other.hexString));
-                hexString[strlen(other.hexString)] = '\0';
-            }
-            data = other.data;
+            memcpy(data, other.data, sizeof(data));
+        }
+
+        /// @brief Takes over the value and any generated hex-string representation of `other`.
+        BigNumber(BigNumber &&other) : size(other.size), sign(other.sign), hexString(other.ReleaseHexString())
+        {
+            memcpy(data, other.data, sizeof(data));
         }
 
         BigNumber &operator=(const BigNumber &other)
         {
             if (this != &other)
             {
-                if (other.hexString != nullptr)
-                {
-                    delete[] hexString;
-                    hexString = new char[strlen(other.hexString) + 1];
-                    memcpy(hexString, other.hexString, strlen(other.hexString) + 1);
-                }
-                data = other.data;
+                delete[] ReleaseHexString();
+                memcpy(data, other.data, sizeof(data));
+                size = other.size;
+                sign = other.sign;
             }
             return *this;
         }
 
-        ~BigNumber()
+        BigNumber &operator=(BigNumber &&other)
         {
-            if (hexString != nullptr)
+            if (this != &other)
             {
-                delete[] hexString;
+                delete[] ReleaseHexString();
+                memcpy(data, other.data, sizeof(data));
+                size = other.size;
+                sign = other.sign;
+                hexString = other.ReleaseHexString();
             }
-            hexString = nullptr;
+            return *this;
+        }
+
+        ~BigNumber()
+        {
+            delete[] ReleaseHexString();
         }
 
-        /// @brief Return the hexadecimal representation of the value.
+        /// @brief Return the hexadecimal representation of the value (prefixed by '-' if negative). The string is generated
+        /// on the first call and is managed by this instance.
+        /// @return
+        char *HexString() const;
+
+        /// @brief Writes the null-terminated hexadecimal representation of the value into `buffer` without allocating.
+        /// @param buffer Destination. Must be able to hold at least `HexStringLength() + 1` characters.
+        /// @param length The size of `buffer`.
+        /// @return The number of characters written (excluding the null-termination) or 0 if `buffer` was too small.
+        size_t WriteHexString(char *buffer, size_t length) const;
+
+        /// @brief Returns the length of the hexadecimal representation (excluding the null-termination).
         /// @return
-        char *HexString() const { return hexString; }
+        size_t HexStringLength() const { return size * 2 * sizeof(uint16_t) + (sign == Sign::Negative ? 1 : 0); }
 
-        /// @brief Return the raw representation of the value.
+        /// @brief Return the raw representation of the value's magnitude.
         /// @return
         std::vector<uint8_t> Bytes() const;
 
-        /// @brief Generates an 32-bit integer value. Will throw if the size contained value is > 4 bytes.
+        /// @brief Writes the magnitude as a 32-byte big-endian value (e.g. an ABI `uint256` slot) without allocating.
+        /// @param out
+        void WriteBigEndian(uint8_t (&out)[32]) const;
+
+        /// @brief Writes the value as a 32-byte big-endian two's complement number (e.g. an ABI `int256` slot) without allocating.
+        /// @param out
+        void WriteTwosComplement(uint8_t (&out)[32]) const;
+
+        /// @brief Returns the number of bytes required to represent the magnitude without leading zeros (0 for zero).
+        size_t MinimalByteLength() const;
+
+        /// @brief Writes the magnitude without leading zeros (as used by RLP) into `buffer`.
+        /// @param buffer Destination. Must be able to hold `MinimalByteLength()` bytes.
+        /// @param length The size of `buffer`.
+        /// @return The number of bytes written or 0 if `buffer` was too small.
+        size_t WriteMinimal(uint8_t *buffer, size_t length) const;
+
+        /// @brief Creates a positive number from a big-endian byte array (e.g. an ABI-encoded `uint256`).
+        /// @param bytes
+        /// @param length The number of bytes in `bytes`. Leading zeros beyond 32 bytes are ignored.
+        /// @return
+        static BigNumber FromBigEndian(const uint8_t *bytes, size_t length);
+
+        /// @brief Returns the value as a big-endian two's complement number.
+        /// @param length The number of bytes to return. Defaults to 32 (int256).
+        /// @return
+        std::vector<uint8_t> TwosComplementBytes(size_t length = 32) const;
+
+        /// @brief Creates a number from a big-endian two's complement representation (e.g. an ABI-encoded `int256`).
+        /// @param bytes
+        /// @param length The number of bytes in `bytes`. At most 32.
+        /// @return
+        static BigNumber FromTwosComplement(const uint8_t *bytes, size_t length);
+
+        /// @brief Returns `true` if the value can be represented by a signed (e.g. `int64`) or unsigned (e.g. `uint64`)
+        /// integer using `bits` bits.
+        bool FitsInBits(uint16_t bits, bool isSigned) const;
+
+        /// @brief Returns `true` if the value is less than zero.
+        bool IsNegative() const { return sign == Sign::Negative; }
+
+        /// @brief Returns `true` if the value is zero.
+        bool IsZero() const;
+
+        /// @brief Arithmetic operators. Will throw if the magnitude of the result exceeds 256 bits or on division by zero.
+        /// Division truncates towards zero and the remainder has the same sign as the dividend (as in Solidity).
+        BigNumber operator-() const;
+        BigNumber operator+(const BigNumber &other) const;
+        BigNumber operator-(const BigNumber &other) const;
+        BigNumber operator*(const BigNumber &other) const;
+        BigNumber operator/(const BigNumber &other) const;
+        BigNumber operator%(const BigNumber &other) const;
+        BigNumber &operator+=(const BigNumber &other) { return *this = *this + other; }
+        BigNumber &operator-=(const BigNumber &other) { return *this = *this - other; }
+        BigNumber &operator*=(const BigNumber &other) { return *this = *this * other; }
+        BigNumber &operator/=(const BigNumber &other) { return *this = *this / other; }
+
+        /// @brief Returns a negative number if this value is less than `other`, 0 if they are equal and a positive number otherwise.
+        int Compare(const BigNumber &other) const;
+        bool operator==(const BigNumber &other) const { return Compare(other) == 0; }
+        bool operator!=(const BigNumber &other) const { return Compare(other) != 0; }
+        bool operator<(const BigNumber &other) const { return Compare(other) < 0; }
+        bool operator<=(const BigNumber &other) const { return Compare(other) <= 0; }
+        bool operator>(const BigNumber &other) const { return Compare(other) > 0; }
+        bool operator>=(const BigNumber &other) const { return Compare(other) >= 0; }
+
+        /// @brief Generates an 32-bit integer value from the magnitude. Will throw if the size contained value is > 4 bytes.
         /// @return
         uint32_t ToUInt32() const;
 
@@ -117,13 +228,20 @@ namespace blockchain
 
         BigNumber *clone() const { return new BigNumber(*this); }
 
-        /// @brief Śign of the number. Currently, only positive numbers are supported.
-        const Sign Sign = Sign::Positive;
-
     private:
-        std::vector<uint16_t> data;
-        char *hexString;
-        void GenerateHexString();
+        /// @brief 16-bit words, least significant word first. Words above `size` are always zero.
+        uint16_t data[BIG_NUMBER_MAX_WORDS];
+        /// @brief The number of words used to represent the value.
+        uint8_t size;
+        Sign sign;
+#ifdef R2WEB3_THREADING_SUPPORTED
+        mutable std::atomic<char *> hexString;
+#else
+        mutable char *hexString;
+#endif
+        char *ReleaseHexString();
+        void SetWords(const uint16_t *words, size_t count);
+        static BigNumber FromWords(const uint16_t *words, Sign sign);
     };
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,177 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2023 Tord Wessman
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __BIG_NUMBER_CONSTANT_H__
+#define __BIG_NUMBER_CONSTANT_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "Common.h"
+
+/// @brief Maximum number of 16-bit words a `BigNumber` can hold (i.e. 256 bits).
+#define BIG_NUMBER_MAX_WORDS 16
+
+// Compile-time constants rely on C++14 `constexpr` (loops and local variables).
+#if __cplusplus >= 201402L
+
+namespace blockchain
+{
+    /// @brief Reports an invalid `BigNumberConstant`. Not being `constexpr`, any call during constant evaluation results in a compile error.
+    inline void bigNumberConstantError(const char *message) { THROW(message); }
+
+    /// @brief A 256-bit unsigned value that can be created at compile time and converted to a `BigNumber` without allocations.
+    /// Usually created using the literals in `blockchain::literals`, e.g. `constexpr BigNumberConstant gasPrice = 30_gwei;`.
+    struct BigNumberConstant
+    {
+        /// @brief Represents '0'
+        constexpr BigNumberConstant() : words{} {}
+
+        /// @brief Constructor using an unsigned 64-bit value.
+        constexpr BigNumberConstant(uint64_t value) : words{(uint16_t)value, (uint16_t)(value >> 16), (uint16_t)(value >> 32), (uint16_t)(value >> 48)} {}
+
+        /// @brief Returns the 16-bit word at `index`, least significant word first.
+        constexpr uint16_t Word(size_t index) const { return words[index]; }
+
+        /// @brief Returns `this * factor + addend`. Fails if the result exceeds 256 bits.
+        constexpr BigNumberConstant MultiplyAdd(uint16_t factor, uint16_t addend) const
+        {
+            BigNumberConstant result;
+            uint32_t carry = addend;
+            for (size_t i = 0; i < BIG_NUMBER_MAX_WORDS; i++)
+            {
+                carry += (uint32_t)words[i] * factor;
+                result.words[i] = carry & 0xFFFF;
+                carry >>= 16;
+            }
+            if (carry != 0) { bigNumberConstantError("BigNumberConstant exceeds 256 bits."); }
+            return result;
+        }
+
+        constexpr bool operator==(const BigNumberConstant &other) const
+        {
+            for (size_t i = 0; i < BIG_NUMBER_MAX_WORDS; i++)
+            {
+                if (words[i] != other.words[i]) { return false; }
+            }
+            return true;
+        }
+
+        constexpr bool operator!=(const BigNumberConstant &other) const { return !(*this == other); }
+
+        /// @brief Parses a decimal (optionally with a fraction) or "0x"-prefixed hexadecimal string and scales it by 10^`decimals`.
+        /// Digit separators (') are ignored.
+        /// @param chars The characters to parse.
+        /// @param length The number of characters in `chars`.
+        /// @param decimals The number of decimals of the unit (e.g. 18 for ether).
+        static constexpr BigNumberConstant Parse(const char *chars, size_t length, uint8_t decimals)
+        {
+            BigNumberConstant value;
+            size_t i = 0;
+            const bool hex = length > 2 && chars[0] == '0' && (chars[1] == 'x' || chars[1] == 'X');
+            bool fraction = false;
+            size_t fractionDigits = 0;
+
+            for (i = hex ? 2 : 0; i < length; i++)
+            {
+                const char c = chars[i];
+                if (c == '\'') { continue; }
+                if (c == '.' && !hex && !fraction) { fraction = true; continue; }
+
+                uint16_t digit = 0;
+                if (c >= '0' && c <= '9') { digit = c - '0'; }
+                else if (hex && c >= 'a' && c <= 'f') { digit = c - 'a' + 10; }
+                else if (hex && c >= 'A' && c <= 'F') { digit = c - 'A' + 10; }
+                else { bigNumberConstantError("Invalid character in BigNumberConstant."); }
+
+                if (fraction && ++fractionDigits > decimals)
+                {
+                    if (digit != 0) { bigNumberConstantError("BigNumberConstant has more decimals than its unit."); }
+                    continue;
+                }
+                value = value.MultiplyAdd(hex ? 16 : 10, digit);
+            }
+
+            for (i = fraction ? fractionDigits : 0; i < decimals; i++)
+            {
+                value = value.MultiplyAdd(10, 0);
+            }
+            return value;
+        }
+
+        uint16_t words[BIG_NUMBER_MAX_WORDS];
+    };
+
+    /// @brief Literals for `BigNumberConstant`s. Integer, hexadecimal and fractional literals are parsed exactly at compile time.
+    /// Example: `using namespace blockchain::literals; constexpr BigNumberConstant fee = 1.5_gwei;`
+    namespace literals
+    {
+        /// @brief A plain 256-bit value. Accepts decimal and hexadecimal literals (e.g. `0xffff'ffff_u256`).
+        template <char... Chars>
+        constexpr BigNumberConstant operator"" _u256()
+        {
+            constexpr char chars[] = {Chars..., '\0'};
+            return BigNumberConstant::Parse(chars, sizeof...(Chars), 0);
+        }
+
+        /// @brief A value in wei.
+        template <char... Chars>
+        constexpr BigNumberConstant operator"" _wei()
+        {
+            constexpr char chars[] = {Chars..., '\0'};
+            return BigNumberConstant::Parse(chars, sizeof...(Chars), 0);
+        }
+
+        /// @brief A value in gwei, converted to wei (e.g. `30_gwei` or `1.5_gwei`).
+        template <char... Chars>
+        constexpr BigNumberConstant operator"" _gwei()
+        {
+            constexpr char chars[] = {Chars..., '\0'};
+            return BigNumberConstant::Parse(chars, sizeof...(Chars), 9);
+        }
+
+        /// @brief A value in ether, converted to wei (e.g. `1_ether` or `0.25_ether`).
+        template <char... Chars>
+        constexpr BigNumberConstant operator"" _ether()
+        {
+            constexpr char chars[] = {Chars..., '\0'};
+            return BigNumberConstant::Parse(chars, sizeof...(Chars), 18);
+        }
+
+        static_assert(0_wei == BigNumberConstant(), "0_wei");
+        static_assert(1_gwei == BigNumberConstant(1000000000ULL), "1_gwei");
+        static_assert(1.5_gwei == BigNumberConstant(1500000000ULL), "1.5_gwei");
+        static_assert(1_ether == BigNumberConstant(1000000000000000000ULL), "1_ether");
+        static_assert(0.25_ether == 250000000_gwei, "0.25_ether");
+        static_assert(0xDEADBEEF_u256 == BigNumberConstant(0xDEADBEEFULL), "hex literal");
+        static_assert(0x10_gwei == 16_gwei, "hex gwei");
+        static_assert(1000_ether == BigNumberConstant(1000000000000000000ULL).MultiplyAdd(1000, 0), "1000_ether");
+        static_assert((0xffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff_u256).Word(15) == 0xFFFF, "uint256 max");
+        static_assert(115792089237316195423570985008687907853269984665640564039457584007913129639935_u256 == 
+                      0xffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff_u256, "uint256 max (decimal)");
+    }
+}
+
+#endif // __cplusplus >= 201402L
+#endif
@@ -150,24 +150,26 @@ namespace blockchain
 
         std::vector<uint8_t> uint_to_bytes_t::operator()(const uint32_t v) const
         {
-            const size_t byteCount = sizeof(v);
+            size_t byteCount = 0;
+            while (byteCount < sizeof(v) && (v >> (byteCount * 8)) != 0) { byteCount++; }
             std::vector<uint8_t> bytes(byteCount);
             for (size_t i = 0; i < byteCount; ++i)
             {
                 bytes[byteCount - i - 1] = static_cast<uint8_t>(v >> (i * 8));
             }
-            return bytes | byte_array::truncate;
+            return bytes;
         }
 
         std::vector<uint8_t> size_to_bytes_t::operator()(const size_t v) const
         {
-            const size_t byteCount = sizeof(v);
+            size_t byteCount = 0;
+            while (byteCount < sizeof(v) && (v >> (byteCount * 8)) != 0) { byteCount++; }
             std::vector<uint8_t> bytes(byteCount);
             for (size_t i = 0; i < byteCount; ++i)
             {
                 bytes[byteCount - i - 1] = static_cast<uint8_t>(v >> (i * 8));
             }
-            return bytes | byte_array::truncate;
+            return bytes;
         }
 
         std::vector<uint8_t> operator|(const std::vector<uint8_t> &v, truncate_t f) { return f(v); }
@@ -38,6 +38,11 @@
     #define THROW(message) throw std::runtime_error(message)
 #endif
 
+// Platforms providing `std::thread`, `std::mutex` and lock-free `std::atomic`.
+#if !defined(ARDUINO) || defined(ESP32)
+    #define R2WEB3_THREADING_SUPPORTED
+#endif
+
 namespace blockchain
 {
 
@@ -59,6 +64,32 @@ namespace blockchain
         const char *value;
     };
 
+    /// @brief A non-owning view of a byte array. The viewed data must outlive the view.
+    class ByteView
+    {
+    public:
+        ByteView() : pointer(nullptr), length(0) {}
+        ByteView(const uint8_t *data, size_t size) : pointer(data), length(size) {}
+        ByteView(const std::vector<uint8_t> &bytes) : pointer(bytes.data()), length(bytes.size()) {}
+
+        /// @brief The first byte of the view.
+        const uint8_t *data() const { return pointer; }
+
+        /// @brief The number of bytes in the view.
+        size_t size() const { return length; }
+
+        const uint8_t &operator[](size_t index) const { return pointer[index]; }
+        const uint8_t *begin() const { return pointer; }
+        const uint8_t *end() const { return pointer + length; }
+
+        /// @brief Returns a copy of the viewed bytes.
+        std::vector<uint8_t> ToVector() const { return std::vector<uint8_t>(pointer, pointer + length); }
+
+    private:
+        const uint8_t *pointer;
+        size_t length;
+    };
+
     /// @brief extensions for `vector<uint8_t>`.
     namespace byte_array
     {
@@ -281,7 +312,7 @@ namespace blockchain
                 {
                     delete[] errorMessage;
                 }
-                errorMessage = other.errorMessage | char_string::retain;
+                errorMessage = other.errorMessage != nullptr ? other.errorMessage | char_string::retain : nullptr;
                 hasValue = other.hasValue;
                 errorCode = other.errorCode;
                 value = other.value;
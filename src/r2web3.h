@@ -27,6 +27,7 @@
 
 #include "Shared/Common.h"
 #include "Shared/R2Web3Log.h"
+#include "Shared/BigNumberConstant.h"
 #include "Shared/BigNumber.h"
 #ifdef ARDUINO
 #include "Network/ESPNetwork.h"
@@ -39,12 +40,24 @@
 #include "Blockchain/Chain.h"
 #include "Blockchain/Account.h"
 #include "Blockchain/Contract.h"
+#include "Blockchain/CalldataTemplate.h"
 #include "Blockchain/Encodable.h"
 #include "Blockchain/RlpEncoder.h"
+#include "Blockchain/RlpDecoder.h"
 #include "Blockchain/Transaction.h"
 #include "Blockchain/EthereumTransaction.h"
 #include "Blockchain/EthereumSigner.h"
+#include "Blockchain/SignedTransactionStore.h"
+#include "Blockchain/TransactionBuilder.h"
+#include "Blockchain/GasEstimateCache.h"
+#include "Blockchain/ContractAddress.h"
 #include "Blockchain/ABIEncoder.h"
+#include "Blockchain/ABIType.h"
 #include "Blockchain/ABIDecoder.h"
+#include "Blockchain/EIP712.h"
+#include "Blockchain/Keccak256Constant.h"
+#include "Blockchain/ContractFunction.h"
+#include "Blockchain/ContractABI.h"
+#include "Blockchain/EventLog.h"
 
 #endif
\ No newline at end of file